@@ -0,0 +1,90 @@
+/*
+ * Benchmark for the bulk operations of buffer::Buffer
+ *
+ * Compares copyToArray() with a loop over at(), and the block pushFront() and
+ * popBack() with the same number of single value calls. Prints nanoseconds per
+ * value for each of them.
+ *
+ * Build from the root of the repository and run:
+ *     g++ -std=c++17 -O3 -Isrc bench/buffer_bench.cpp -o buffer_bench
+ *     ./buffer_bench [repeats]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include "buffer.h"
+
+namespace
+{
+    constexpr unsigned int buffer_size = 4096;
+    constexpr unsigned int block_size = 64;
+
+    using Buffer = buffer::Buffer<float, unsigned int>;
+
+    float memory[buffer_size];
+    float array[buffer_size];
+    volatile float sink;
+
+    // Run the test the given number of times and return nanoseconds per value
+    template <class test_t>
+    double measure(unsigned long repeats, unsigned int values, test_t test)
+    {
+        const auto start = std::chrono::steady_clock::now();
+
+        for(unsigned long r = 0; r < repeats; ++r)
+        {
+            test();
+            // Keep the results from being optimized away
+            sink = array[r % values];
+        }
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        return seconds * 1e9 / double(repeats) / values;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned long repeats = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 200000UL;
+
+    Buffer buffer(memory, buffer_size);
+
+    // Fill the buffer and move the head away from the start of the memory, so the values wrap around
+    for(unsigned int i = 0; i < buffer_size + buffer_size / 3; ++i) buffer.pushFront(float(i));
+
+    const unsigned int count = buffer.count();
+
+    std::printf("copy of %u values, ns per value\n", count);
+    std::printf("  at() loop:                 %6.3f\n", measure(repeats, count, [&]
+    {
+        for(unsigned int i = 0; i < count; ++i) array[i] = buffer.at(i);
+    }));
+    std::printf("  copyToArray() newest first:%6.3f\n", measure(repeats, count, [&]
+    {
+        buffer.copyToArray(array);
+    }));
+    std::printf("  copyToArray() oldest first:%6.3f\n", measure(repeats, count, [&]
+    {
+        buffer.copyToArray(array, 0, 0, true);
+    }));
+
+    // Push and pop blocks in a half full buffer, so that the indexes keep moving around the memory
+    buffer.clear();
+    for(unsigned int i = 0; i < buffer_size / 2; ++i) buffer.pushFront(float(i));
+
+    std::printf("push and pop of %u values, ns per value\n", block_size);
+    std::printf("  single values:             %6.3f\n", measure(repeats * 16, block_size, [&]
+    {
+        for(unsigned int i = 0; i < block_size; ++i) buffer.pushFront(array[i]);
+        for(unsigned int i = 0; i < block_size; ++i) buffer.popBack(array + i);
+    }));
+    std::printf("  blocks:                    %6.3f\n", measure(repeats * 16, block_size, [&]
+    {
+        buffer.pushFront(array, block_size);
+        buffer.popBack(array, block_size);
+    }));
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+/*
+ * Throughput benchmark for buffer::SpscBuffer
+ *
+ * One producer thread and one consumer thread pass values through the buffer,
+ * first one value per call, then in blocks. Prints millions of values per second.
+ * Run it on a machine with at least two cores, otherwise the threads take turns.
+ *
+ * Build from the root of the repository and run:
+ *     g++ -std=c++17 -O2 -pthread -Isrc bench/spscbuffer_bench.cpp -o spscbuffer_bench
+ *     ./spscbuffer_bench [values]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "spscbuffer.h"
+
+namespace
+{
+    constexpr unsigned int block_size = 64;
+
+    double run(float *memory, unsigned int size, unsigned long values, bool blocks)
+    {
+        buffer::SpscBuffer<float, unsigned int> queue(memory, size);
+        float checksum = 0.0F;
+
+        const auto start = std::chrono::steady_clock::now();
+
+        std::thread producer([&]
+        {
+            float block[block_size] = {};
+            unsigned long pushed = 0;
+            while(pushed < values)
+            {
+                if(blocks)
+                {
+                    const unsigned long count = values - pushed < block_size ? values - pushed : block_size;
+                    pushed += queue.pushFront(block, static_cast<unsigned int>(count));
+                }
+                else if(queue.pushFront(1.0F))
+                {
+                    ++pushed;
+                }
+            }
+        });
+
+        std::thread consumer([&]
+        {
+            float block[block_size];
+            unsigned long poped = 0;
+            while(poped < values)
+            {
+                if(blocks)
+                {
+                    const unsigned int count = queue.popBack(block, block_size);
+                    for(unsigned int i = 0; i < count; ++i) checksum += block[i];
+                    poped += count;
+                }
+                else
+                {
+                    float value;
+                    if(queue.popBack(&value))
+                    {
+                        checksum += value;
+                        ++poped;
+                    }
+                }
+            }
+        });
+
+        producer.join();
+        consumer.join();
+
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Keep the consumer loop from being optimized away
+        if(checksum < 0.0F) std::printf("%f\n", double(checksum));
+
+        return double(values) / seconds / 1e6;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned long values = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 50000000UL;
+
+    static float memory[4096];
+
+    std::printf("single values: %8.1f Mvalues/s\n", run(memory, 4096, values, false));
+    std::printf("blocks of %u:  %8.1f Mvalues/s\n", block_size, run(memory, 4096, values, true));
+
+    return 0;
+}
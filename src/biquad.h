@@ -0,0 +1,233 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Second order IIR filter section (biquad). A single biquad is a second order
+ * low pass, high pass, band pass, notch, ... depending on its coefficients.
+ * Several sections in series, see SosCascade, give higher order filters with
+ * sharper roll-off.
+ *
+ * BiquadCoefficients holds the coefficients of a section, normalized so a0 = 1,
+ * and calculates them for low pass and high pass filters.
+ *
+ * ALGORITHM
+ * ---------
+ * Transposed direct form II:
+ * y[i]  := b0 * x[i] + s1[i-1]
+ * s1[i] := b1 * x[i] - a1 * y[i] + s2[i-1]
+ * s2[i] := b2 * x[i] - a2 * y[i]
+ *
+ * PROS
+ * ----
+ * 1. Five multiplications and two state values per section
+ * 2. Transposed direct form II has good numerical behaviour with floating point
+ *
+ * CONS
+ * ----
+ * 1. Floating point only
+ * 2. Poles close to the unit circle, very low cutoff frequencies, need double
+ *    precision coefficients
+ *
+ * TYPE
+ * ----
+ * IIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t  - Type of the data, the filter will work with
+ * uint_t  - Type of unsigned integers used troughout the class.
+ *           This type should be chosen carefully based on the CPU/MCU for
+ *           optimal performance. A default type of 16-bit unsigned int is
+ *           sufficient for most cases.
+ * coeff_t - Type of the coefficients. float or double
+ */
+
+#ifndef BIQUAD_H
+#define BIQUAD_H
+
+#include <type_traits>
+#include <cmath>
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class coeff_t = float>
+    struct BiquadCoefficients
+    {
+        static_assert (std::is_floating_point_v<coeff_t>, "Template type \"coeff_t\" expected to be floating point");
+
+        coeff_t b0;
+        coeff_t b1;
+        coeff_t b2;
+        coeff_t a1;
+        coeff_t a2;
+
+        /**
+         * @brief lowPass Second order low pass
+         * @param frequency Cutoff frequency divided by the sample rate, in the range (0, 0.5)
+         * @param q Quality factor. The default gives a Butterworth response
+         */
+        static BiquadCoefficients lowPass(coeff_t frequency, coeff_t q = coeff_t(0.70710678118654752));
+        // Second order high pass. Same parameters as lowPass()
+        static BiquadCoefficients highPass(coeff_t frequency, coeff_t q = coeff_t(0.70710678118654752));
+        /**
+         * @brief butterworthQ Quality factor of one section of a Butterworth filter of order 2 * sections
+         * @param sections The number of sections
+         * @param section The index of the section, from 0 to sections - 1
+         */
+        static coeff_t butterworthQ(unsigned int sections, unsigned int section);
+
+        static constexpr double pi = 3.14159265358979323846;
+    };
+
+    template <class data_t, class uint_t = unsigned short int, class coeff_t = float>
+    class Biquad
+    {
+        public:
+            Biquad(const BiquadCoefficients<coeff_t> &coefficients);
+            data_t out();
+            void in(const data_t& value);
+            /**
+             * @brief process Filter a block of values. Same result as calling in() and out()
+             *                for every value
+             * @param src Pointer to the values
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param count Number of values
+             */
+            void process(const data_t *src, data_t *dst, uint_t count);
+            void reset(const BiquadCoefficients<coeff_t> &coefficients);
+            void reset();
+
+        private:
+            // Filters blocks with several sections at once
+            template <class, class, class> friend class SosCascade;
+
+            BiquadCoefficients<coeff_t> m_coefficients;
+            data_t m_out;
+            data_t m_s1;
+            data_t m_s2;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    // Robert Bristow-Johnson, Cookbook formulae for audio equalizer biquad filter coefficients
+    template <class coeff_t>
+    BiquadCoefficients<coeff_t> BiquadCoefficients<coeff_t>::lowPass(coeff_t frequency, coeff_t q)
+    {
+        const coeff_t w0 = coeff_t(2 * pi) * frequency;
+        const coeff_t cos_w0 = std::cos(w0);
+        const coeff_t alpha = std::sin(w0) / (2 * q);
+        const coeff_t a0 = 1 + alpha;
+
+        return {(1 - cos_w0) / 2 / a0, (1 - cos_w0) / a0, (1 - cos_w0) / 2 / a0, -2 * cos_w0 / a0, (1 - alpha) / a0};
+    }
+
+    template <class coeff_t>
+    BiquadCoefficients<coeff_t> BiquadCoefficients<coeff_t>::highPass(coeff_t frequency, coeff_t q)
+    {
+        const coeff_t w0 = coeff_t(2 * pi) * frequency;
+        const coeff_t cos_w0 = std::cos(w0);
+        const coeff_t alpha = std::sin(w0) / (2 * q);
+        const coeff_t a0 = 1 + alpha;
+
+        return {(1 + cos_w0) / 2 / a0, -(1 + cos_w0) / a0, (1 + cos_w0) / 2 / a0, -2 * cos_w0 / a0, (1 - alpha) / a0};
+    }
+
+    template <class coeff_t>
+    coeff_t BiquadCoefficients<coeff_t>::butterworthQ(unsigned int sections, unsigned int section)
+    {
+        // The poles of the filter are evenly spaced on a half circle
+        return coeff_t(1 / (2 * std::cos(pi * (2 * section + 1) / (4 * sections))));
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    Biquad<data_t, uint_t, coeff_t>::Biquad(const BiquadCoefficients<coeff_t> &coefficients):
+        m_coefficients(coefficients),
+        m_out(data_t()),
+        m_s1(data_t()),
+        m_s2(data_t())
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_floating_point_v<data_t>, "Template type \"data_t\" expected to be floating point");
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    data_t Biquad<data_t, uint_t, coeff_t>::out()
+    {
+        return m_out;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void Biquad<data_t, uint_t, coeff_t>::in(const data_t& value)
+    {
+        const BiquadCoefficients<coeff_t> &c = m_coefficients;
+
+        m_out = c.b0 * value + m_s1;
+        m_s1 = c.b1 * value - c.a1 * m_out + m_s2;
+        m_s2 = c.b2 * value - c.a2 * m_out;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void Biquad<data_t, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t count)
+    {
+        // Keep the coefficients and the state in local variables, so they are not reloaded after every store to dst
+        const coeff_t b0 = m_coefficients.b0, b1 = m_coefficients.b1, b2 = m_coefficients.b2;
+        const coeff_t a1 = m_coefficients.a1, a2 = m_coefficients.a2;
+        data_t out = m_out, s1 = m_s1, s2 = m_s2;
+
+        for(uint_t i = 0; i < count; ++i)
+        {
+            const data_t value = src[i];
+            out = b0 * value + s1;
+            s1 = b1 * value - a1 * out + s2;
+            s2 = b2 * value - a2 * out;
+            dst[i] = out;
+        }
+
+        m_out = out;
+        m_s1 = s1;
+        m_s2 = s2;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void Biquad<data_t, uint_t, coeff_t>::reset(const BiquadCoefficients<coeff_t> &coefficients)
+    {
+        m_coefficients = coefficients;
+        reset();
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void Biquad<data_t, uint_t, coeff_t>::reset()
+    {
+        m_out = data_t();
+        m_s1 = data_t();
+        m_s2 = data_t();
+    }
+}
+
+#endif // BIQUAD_H
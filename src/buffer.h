@@ -27,7 +27,8 @@
  * to be achieved the buffer size must be a power of two(2, 4, 8, 16, 32, ...).
  * Since this is circular buffer the real size is always the set value minus one. One element is
  * wasted for the head pointer. For example if you set the buffer size to 16 elements,
- * then the real size if 15 elements.
+ * then the real size if 15 elements. In full capacity mode the buffer tracks fullness
+ * with the number of elements instead, so the real size is the set value.
  * The buffer algorithms are self contained and do not use external dependencies. This
  * makes is suitable for embedded systems and MCUs.
  *
@@ -42,7 +43,12 @@
  * CONS
  * ----
  * 1. The size of the buffer passed to the constructor must have size a power of 2
- * 2. The real size is allways -1 bucause of the head pointer
+ * 2. Unless full_capacity is set, the real size is always one less than the set size,
+ *    because one bucket is left empty to tell a full buffer from an empty one
+ *
+ * The memory is either passed to the constructor or, when the size N is known at compile
+ * time, embedded in the object. StaticBuffer<data_t, N> embeds the memory, so the
+ * indexes and the values share the same cache lines and the mask is a constant.
  *
  * DATA TYPES
  * ----------
@@ -51,6 +57,10 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * N      - Size of the embedded memory. Must be a power of two. If 0, the memory
+ *          is passed to the constructor
+ * full_capacity - If set, all elements of the memory are used and the real size
+ *                 is a power of two
  */
 
 #ifndef BUFFER_H
@@ -58,6 +68,10 @@
 
 #include <type_traits>
 #include <stdexcept>
+#include <limits>
+#include <cstring>
+#include <cstddef>
+#include <iterator>
 
 namespace buffer
 {
@@ -75,9 +89,118 @@ namespace buffer
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int> class Buffer
+    /* Random access iterator over the values of a Buffer. The position is not masked, so
+     * stepping is a plain addition and the mask is applied only when the value is accessed.
+     * Iterates from the newest to the oldest value if newest_first is set, otherwise from
+     * the oldest to the newest.
+     */
+    template <class data_t, class uint_t, bool newest_first, bool constant> class BufferIterator
     {
+            template <class, class, bool, bool> friend class BufferIterator;
+
         public:
+            using iterator_category = std::random_access_iterator_tag;
+            using value_type = data_t;
+            using difference_type = std::ptrdiff_t;
+            using pointer = std::conditional_t<constant, const data_t*, data_t*>;
+            using reference = std::conditional_t<constant, const data_t&, data_t&>;
+
+            BufferIterator(): m_buffer(nullptr), m_mask(0), m_position(0) {}
+            BufferIterator(pointer buffer, uint_t mask, difference_type position): m_buffer(buffer), m_mask(mask), m_position(position) {}
+
+            // A mutable iterator converts to a constant one
+            template <bool other_constant, class = std::enable_if_t<constant && !other_constant>>
+            BufferIterator(const BufferIterator<data_t, uint_t, newest_first, other_constant>& other): m_buffer(other.m_buffer), m_mask(other.m_mask), m_position(other.m_position) {}
+
+            reference operator*() const { return m_buffer[std::size_t(m_position) & m_mask]; }
+            pointer operator->() const { return &operator*(); }
+            reference operator[](difference_type n) const { return m_buffer[std::size_t(m_position + n * step) & m_mask]; }
+
+            BufferIterator& operator++() { m_position += step; return *this; }
+            BufferIterator& operator--() { m_position -= step; return *this; }
+            BufferIterator operator++(int) { BufferIterator it = *this; m_position += step; return it; }
+            BufferIterator operator--(int) { BufferIterator it = *this; m_position -= step; return it; }
+            BufferIterator& operator+=(difference_type n) { m_position += n * step; return *this; }
+            BufferIterator& operator-=(difference_type n) { m_position -= n * step; return *this; }
+            BufferIterator operator+(difference_type n) const { return BufferIterator(m_buffer, m_mask, m_position + n * step); }
+            BufferIterator operator-(difference_type n) const { return BufferIterator(m_buffer, m_mask, m_position - n * step); }
+            friend BufferIterator operator+(difference_type n, const BufferIterator& it) { return it + n; }
+            difference_type operator-(const BufferIterator& other) const { return (m_position - other.m_position) * step; }
+
+            bool operator==(const BufferIterator& other) const { return m_position == other.m_position; }
+            bool operator!=(const BufferIterator& other) const { return m_position != other.m_position; }
+            bool operator<(const BufferIterator& other) const { return *this - other < 0; }
+            bool operator>(const BufferIterator& other) const { return *this - other > 0; }
+            bool operator<=(const BufferIterator& other) const { return *this - other <= 0; }
+            bool operator>=(const BufferIterator& other) const { return *this - other >= 0; }
+
+        private:
+            static constexpr difference_type step = newest_first ? -1 : 1;
+
+            pointer m_buffer;
+            std::size_t m_mask;
+            difference_type m_position;
+    };
+
+    // Embedded memory with a size known at compile time
+    template <class data_t, class uint_t, unsigned int N> class BufferStorage
+    {
+            static_assert (N >= 4 && !(N & (N - 1)), "Template parameter \"N\" expected to be a power of two(4, 8, 16, 32, ...)");
+            static_assert (N - 1 <= std::numeric_limits<uint_t>::max(), "Template parameter \"N\" does not fit in template type \"uint_t\"");
+
+        protected:
+            BufferStorage(): m_buffer() {}
+
+            static constexpr uint_t m_buffer_mask = N - 1;
+            data_t m_buffer[N];
+    };
+
+    // External memory passed at run time
+    template <class data_t, class uint_t> class BufferStorage<data_t, uint_t, 0>
+    {
+        protected:
+            BufferStorage(): m_buffer_mask(0), m_buffer(nullptr) {}
+
+            uint_t m_buffer_mask;
+            data_t* m_buffer;
+    };
+
+    template <class data_t, class uint_t = unsigned short int, unsigned int N = 0, bool full_capacity = false>
+    class Buffer: private BufferStorage<data_t, uint_t, N>
+    {
+            using Storage = BufferStorage<data_t, uint_t, N>;
+
+            static_assert (!full_capacity || N == 0 || N - 1 < std::numeric_limits<uint_t>::max(), "Template parameter \"N\" does not fit in template type \"uint_t\" in full capacity mode");
+
+        public:
+            // Contiguous part of the buffer memory, ordered from the oldest to the newest value
+            struct Segment
+            {
+                    data_t* data;
+                    uint_t size;
+            };
+
+            // The buffer contents as at most two segments. The back segment holds the oldest
+            // values, the front segment the newest ones. For newest-first order, traverse the
+            // front segment and then the back segment, both from their end
+            struct Segments
+            {
+                    Segment back;
+                    Segment front;
+            };
+
+            // Iterators from the newest to the oldest value, in the same order as at()
+            using iterator = BufferIterator<data_t, uint_t, true, false>;
+            using const_iterator = BufferIterator<data_t, uint_t, true, true>;
+            // Iterators from the oldest to the newest value
+            using reverse_iterator = BufferIterator<data_t, uint_t, false, false>;
+            using const_reverse_iterator = BufferIterator<data_t, uint_t, false, true>;
+
+        public:
+            /**
+             * @brief Buffer Construct a circular buffer object. If N is 0, the buffer is
+             *        invalid until init() is called with the memory
+             */
             Buffer();
             /**
              * @brief Buffer Construct a circular buffer object
@@ -91,11 +214,26 @@ namespace buffer
 
             inline Buffer& init(data_t* buffer = nullptr, uint_t size = 0, bool safe_erase = false);
             inline Buffer& pushFront(const data_t& value);
+            /**
+             * @brief pushFront Push a block of values. Same result as pushing them one
+             *                  by one, src[0] first. If the block is bigger than the
+             *                  buffer, only its newest values are kept
+             * @param src Pointer to the values
+             * @param count Number of values
+             */
+            inline Buffer& pushFront(const data_t* src, uint_t count);
             inline Buffer& pushBack(const data_t& value);
             inline Buffer& popFront(data_t* value = nullptr);
             inline Buffer& popBack(data_t* value = nullptr);
+            /**
+             * @brief popBack Pop a block of the oldest values, the oldest one first.
+             *                If the buffer holds less values, all of them are poped
+             * @param dst Pointer to the memory for the values. If nullptr, the values are discarded
+             * @param count Number of values
+             */
+            inline Buffer& popBack(data_t* dst, uint_t count);
             inline Buffer& clear();
-            inline Buffer* getRawPtr();
+            inline data_t* getRawPtr();
             inline bool full();
             inline bool empty();
             inline bool valid();
@@ -105,42 +243,74 @@ namespace buffer
             inline data_t last();
             inline void erase();
             inline data_t at(uint_t index);
+            inline Segments segments();
             inline Buffer& rotateForeward();
             inline Buffer& rotateBackward();
-            inline void copyToArray(data_t* array, uint_t start = 0, uint_t count = 0);
+            /**
+             * @brief copyToArray Copy a range of values to an array
+             * @param array Pointer to the destination. The first copied value goes to array[0]
+             * @param start Index of the first value, counted from the newest one as in at()
+             * @param count Number of values. If 0, all values from start to the oldest one are copied
+             * @param oldest_first If set the values are copied from the oldest to the newest,
+             *                     otherwise from the newest to the oldest as in at()
+             */
+            inline void copyToArray(data_t* array, uint_t start = 0, uint_t count = 0, bool oldest_first = false);
             inline data_t& operator[](uint_t index);
+            inline iterator begin();
+            inline iterator end();
+            inline const_iterator cbegin();
+            inline const_iterator cend();
+            inline reverse_iterator rbegin();
+            inline reverse_iterator rend();
+            inline const_reverse_iterator crbegin();
+            inline const_reverse_iterator crend();
             inline Buffer& operator<<(const data_t& value);
             inline Buffer& operator>>(data_t& value);
 
         private:
-            uint_t m_buffer_mask;
+            inline uint_t capacity();
+            static inline void copy(data_t* dst, const data_t* src, uint_t count);
+            static inline void copyReversed(data_t* dst, const data_t* src, uint_t count);
+
+        private:
+            using Storage::m_buffer_mask;
+            using Storage::m_buffer;
             uint_t m_buffer_tail;
             uint_t m_buffer_head;
             uint_t m_buffer_count;
-            data_t* m_buffer;
             bool   m_safe_erase;
     };
 
+    // Circular buffer with embedded memory of N elements
+    template <class data_t, unsigned int N, class uint_t = unsigned short int, bool full_capacity = false>
+    using StaticBuffer = Buffer<data_t, uint_t, N, full_capacity>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>::Buffer():
-        Buffer(nullptr, 0)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>::Buffer():
+        Storage(),
+        m_buffer_tail(0),
+        m_buffer_head(0),
+        m_buffer_count(0),
+        m_safe_erase(false)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>::Buffer(data_t* buffer, uint_t size, bool safe_erase):
-        m_buffer_mask(0),
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>::Buffer(data_t* buffer, uint_t size, bool safe_erase):
+        Storage(),
         m_buffer_tail(0),
         m_buffer_head(0),
         m_buffer_count(0),
-        m_buffer(nullptr),
         m_safe_erase(safe_erase)
     {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (N == 0, "Buffer with embedded memory can not be constructed with external memory");
+
         // Buffer size of size smaller than 4 doesn't make sense. Sizes of
         // 1 and 3 are not power of two. Size of 2 means the real buffer
         // size will be 1 element. Buffer with 1 element is not buffer at all,
@@ -171,29 +341,34 @@ namespace buffer
 
         }
 
-        m_buffer_mask = buffer ? size - 1 : 0;
-        m_buffer = buffer;
+        if constexpr(N == 0)
+        {
+            m_buffer_mask = buffer ? size - 1 : 0;
+            m_buffer = buffer;
+        }
 
         if(m_safe_erase)
             erase();
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>::~Buffer()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>::~Buffer()
     {
         if(m_safe_erase)
             erase();
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>* Buffer<data_t, uint_t>::getRawPtr()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    data_t* Buffer<data_t, uint_t, N, full_capacity>::getRawPtr()
     {
         return m_buffer;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::init(data_t* buffer, uint_t size, bool safe_erase)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::init(data_t* buffer, uint_t size, bool safe_erase)
     {
+        static_assert (N == 0, "Buffer with embedded memory can not be initialized with external memory");
+
         // Reset the buffer indexes
         m_buffer_tail = 0;
         m_buffer_head = 0;
@@ -201,18 +376,21 @@ namespace buffer
         m_safe_erase = safe_erase;
 
         // If the buffer is not the same
-        if(buffer != m_buffer)
+        if constexpr(N == 0)
         {
-            // If nullptr passed as buffer pointer, then clear the member variables
-            if(buffer == nullptr)
+            if(buffer != m_buffer)
             {
-                m_buffer_mask = 0;
-                m_buffer = nullptr;
-            }
-            else
-            {
-                m_buffer_mask = size - 1;
-                m_buffer = buffer;
+                // If nullptr passed as buffer pointer, then clear the member variables
+                if(buffer == nullptr)
+                {
+                    m_buffer_mask = 0;
+                    m_buffer = nullptr;
+                }
+                else
+                {
+                    m_buffer_mask = size - 1;
+                    m_buffer = buffer;
+                }
             }
         }
 
@@ -223,40 +401,80 @@ namespace buffer
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::pushFront(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::pushFront(const data_t& value)
     {
-        if(m_buffer == nullptr)
+        if(!valid())
             return *this;
 
-        m_buffer[m_buffer_head] = value;
-        (++m_buffer_head) &= m_buffer_mask;
-        if(m_buffer_head==m_buffer_tail)
+        // When the buffer is full, the oldest value is overwritten
+        if(m_buffer_count == capacity())
             ++m_buffer_tail &= m_buffer_mask;
         else ++m_buffer_count;
 
+        m_buffer[m_buffer_head] = value;
+        (++m_buffer_head) &= m_buffer_mask;
+
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::pushBack(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::pushFront(const data_t* src, uint_t count)
     {
-        if(m_buffer == nullptr)
+        if(!valid() || src == nullptr || count == 0)
             return *this;
 
-        (--m_buffer_tail) &= m_buffer_mask;
-        m_buffer[m_buffer_tail] = value;
-        if(m_buffer_head==m_buffer_tail)
+        const uint_t buffer_capacity = capacity();
+
+        // Only the newest values fit in the buffer
+        if(count > buffer_capacity)
+        {
+            src += count - buffer_capacity;
+            count = buffer_capacity;
+        }
+
+        // Copy in at most two segments: up to the end of the memory and then from its beginning
+        uint_t first_segment = m_buffer_mask + 1 - m_buffer_head;
+        if(first_segment > count)
+            first_segment = count;
+
+        copy(m_buffer + m_buffer_head, src, first_segment);
+        copy(m_buffer, src + first_segment, count - first_segment);
+
+        m_buffer_head = (m_buffer_head + count) & m_buffer_mask;
+
+        // If the oldest values were overwritten, the tail follows the head
+        if(count > buffer_capacity - m_buffer_count)
+        {
+            m_buffer_count = buffer_capacity;
+            m_buffer_tail = (m_buffer_head - buffer_capacity) & m_buffer_mask;
+        }
+        else m_buffer_count += count;
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::pushBack(const data_t& value)
+    {
+        if(!valid())
+            return *this;
+
+        // When the buffer is full, the newest value is overwritten
+        if(m_buffer_count == capacity())
             (--m_buffer_head) &= m_buffer_mask;
         else ++m_buffer_count;
 
+        (--m_buffer_tail) &= m_buffer_mask;
+        m_buffer[m_buffer_tail] = value;
+
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::popFront(data_t* value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::popFront(data_t* value)
     {
-        if(m_buffer == nullptr || m_buffer_tail == m_buffer_head)
+        if(!valid() || m_buffer_count == 0)
             return *this;
 
         (--m_buffer_head) &= m_buffer_mask;
@@ -267,10 +485,10 @@ namespace buffer
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::popBack(data_t* value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::popBack(data_t* value)
     {
-        if(m_buffer == nullptr || m_buffer_tail == m_buffer_head)
+        if(!valid() || m_buffer_count == 0)
             return *this;
 
         if(value)
@@ -281,8 +499,34 @@ namespace buffer
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::clear()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::popBack(data_t* dst, uint_t count)
+    {
+        if(!valid())
+            return *this;
+
+        if(count > m_buffer_count)
+            count = m_buffer_count;
+
+        if(dst)
+        {
+            // Copy in at most two segments: up to the end of the memory and then from its beginning
+            uint_t first_segment = m_buffer_mask + 1 - m_buffer_tail;
+            if(first_segment > count)
+                first_segment = count;
+
+            copy(dst, m_buffer + m_buffer_tail, first_segment);
+            copy(dst + first_segment, m_buffer, count - first_segment);
+        }
+
+        m_buffer_tail = (m_buffer_tail + count) & m_buffer_mask;
+        m_buffer_count -= count;
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::clear()
     {
         m_buffer_tail = 0;
         m_buffer_head = 0;
@@ -294,80 +538,99 @@ namespace buffer
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    bool Buffer<data_t, uint_t>::full()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    bool Buffer<data_t, uint_t, N, full_capacity>::full()
     {
-        return m_buffer_count==m_buffer_mask;
+        return m_buffer_count == capacity();
     }
 
-    template<class data_t, class uint_t>
-    bool Buffer<data_t, uint_t>::empty()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    bool Buffer<data_t, uint_t, N, full_capacity>::empty()
     {
-        return m_buffer_tail == m_buffer_head;
+        return m_buffer_count == 0;
     }
 
-    template<class data_t, class uint_t>
-    bool Buffer<data_t, uint_t>::valid()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    bool Buffer<data_t, uint_t, N, full_capacity>::valid()
     {
-        return m_buffer != nullptr;
+        // Embedded memory is always valid
+        if constexpr(N != 0)
+            return true;
+        else
+            return m_buffer != nullptr;
     }
 
-    template<class data_t, class uint_t>
-    uint_t Buffer<data_t, uint_t>::size()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    uint_t Buffer<data_t, uint_t, N, full_capacity>::size()
     {
-        return m_buffer_mask==0?0:m_buffer_mask;
+        return m_buffer_mask==0?0:capacity();
     }
 
-    template<class data_t, class uint_t>
-    uint_t Buffer<data_t, uint_t>::count()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    uint_t Buffer<data_t, uint_t, N, full_capacity>::count()
     {
         return m_buffer_count;
     }
 
-    template<class data_t, class uint_t>
-    data_t Buffer<data_t, uint_t>::first()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    data_t Buffer<data_t, uint_t, N, full_capacity>::first()
     {
-        if(m_buffer == nullptr || m_buffer_head == m_buffer_tail)
+        if(!valid() || m_buffer_count == 0)
             return data_t();
         return m_buffer[(m_buffer_head-1) & m_buffer_mask];
     }
 
-    template<class data_t, class uint_t>
-    data_t Buffer<data_t, uint_t>::last()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    data_t Buffer<data_t, uint_t, N, full_capacity>::last()
     {
-        if(m_buffer == nullptr || m_buffer_head == m_buffer_tail)
+        if(!valid() || m_buffer_count == 0)
             return data_t();
         return m_buffer[m_buffer_tail];
     }
 
-    template<class data_t, class uint_t>
-    void Buffer<data_t, uint_t>::erase()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    void Buffer<data_t, uint_t, N, full_capacity>::erase()
     {
-        if(m_buffer == nullptr)
+        if(!valid())
             return;
 
         for(uint_t i = 0; i<m_buffer_mask+1; ++i) m_buffer[i] = data_t();
     }
 
-    template<class data_t, class uint_t>
-    data_t Buffer<data_t, uint_t>::at(uint_t index)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    data_t Buffer<data_t, uint_t, N, full_capacity>::at(uint_t index)
     {
-        if(m_buffer == nullptr || index > (m_buffer_count - 1))
+        if(!valid() || index > (m_buffer_count - 1))
             return data_t();
         return m_buffer[(m_buffer_head - 1 - index) & m_buffer_mask];
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::rotateForeward()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::Segments Buffer<data_t, uint_t, N, full_capacity>::segments()
+    {
+        // If the values do not wrap around the end of the memory, there is a single segment
+        uint_t back_size = m_buffer_mask + 1 - m_buffer_tail;
+        if(back_size > m_buffer_count)
+            back_size = m_buffer_count;
+
+        return {{m_buffer + m_buffer_tail, back_size}, {m_buffer, uint_t(m_buffer_count - back_size)}};
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::rotateForeward()
     {
         // Should rotate only full buffer
-        if(m_buffer_count!=m_buffer_mask)
+        if(!full())
             return *this;
 
-        // Swap tail and head elements. This is necessary because head is pointing to an invalid element
-        data_t tmp_swap = m_buffer[m_buffer_head];
-        m_buffer[m_buffer_head] = m_buffer[m_buffer_tail];
-        m_buffer[m_buffer_tail] = tmp_swap;
+        // Swap tail and head elements. This is necessary because head is pointing to an invalid element.
+        // In full capacity mode head and tail point to the same element
+        if constexpr(!full_capacity)
+        {
+            data_t tmp_swap = m_buffer[m_buffer_head];
+            m_buffer[m_buffer_head] = m_buffer[m_buffer_tail];
+            m_buffer[m_buffer_tail] = tmp_swap;
+        }
 
         (++m_buffer_head) &= m_buffer_mask;
         (++m_buffer_tail) &= m_buffer_mask;
@@ -375,17 +638,21 @@ namespace buffer
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::rotateBackward()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::rotateBackward()
     {
         // Should rotate only full buffer
-        if(m_buffer_count!=m_buffer_mask)
+        if(!full())
             return *this;
 
-        // Swap head and the first elements. This is necessary because head is pointing to an invalid element
-        data_t tmp_swap = m_buffer[(m_buffer_head - 1) & m_buffer_mask];
-        m_buffer[(m_buffer_head - 1) & m_buffer_mask] = m_buffer[m_buffer_head];
-        m_buffer[m_buffer_head] = tmp_swap;
+        // Swap head and the first elements. This is necessary because head is pointing to an invalid element.
+        // In full capacity mode head points to the last element, so it is enough to move the indexes
+        if constexpr(!full_capacity)
+        {
+            data_t tmp_swap = m_buffer[(m_buffer_head - 1) & m_buffer_mask];
+            m_buffer[(m_buffer_head - 1) & m_buffer_mask] = m_buffer[m_buffer_head];
+            m_buffer[m_buffer_head] = tmp_swap;
+        }
 
         (--m_buffer_head) &= m_buffer_mask;
         (--m_buffer_tail) &= m_buffer_mask;
@@ -393,49 +660,142 @@ namespace buffer
         return *this;
     }
 
-    // !!! IMPORTANT - OPTIMIZE FOR SPEED !!!
-    // !!! IMPORTANT - OPTIMIZE FOR SPEED !!!
-    // !!! IMPORTANT - OPTIMIZE FOR SPEED !!!
-    template<class data_t, class uint_t>
-    void Buffer<data_t, uint_t>::copyToArray(data_t* array, uint_t start, uint_t count)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    void Buffer<data_t, uint_t, N, full_capacity>::copyToArray(data_t* array, uint_t start, uint_t count, bool oldest_first)
     {
         // Pointers must be valid
-        if(m_buffer == nullptr || array == nullptr)
-            return;
-        // Buffer must not be empty
-        else if(m_buffer_head == m_buffer_tail)
+        if(!valid() || array == nullptr)
             return;
+
         // Can not access elements outside array boundaries
-        else if((start+count)>(m_buffer_count-1))
+        if(count == 0)
+        {
+            if(start >= m_buffer_count)
+                return;
+            count = m_buffer_count - start;
+        }
+        else if(start > m_buffer_count || count > m_buffer_count - start)
             return;
 
-        uint_t last_index = start + count;
-        if(count == 0)
-            last_index = m_buffer_count ;
+        // The range is contiguous in the circular buffer. In the memory it is split in at most
+        // two segments: from its oldest value to the end of the memory and from the beginning
+        const uint_t oldest = (m_buffer_head - start - count) & m_buffer_mask;
+        uint_t first_segment = m_buffer_mask + 1 - oldest;
+        if(first_segment > count)
+            first_segment = count;
+        const uint_t second_segment = count - first_segment;
 
-        for(uint_t i = start; i < last_index; ++i)
-            array[i] = m_buffer[(m_buffer_head - 1 - i) & m_buffer_mask];
+        if(oldest_first)
+        {
+            copy(array, m_buffer + oldest, first_segment);
+            copy(array + first_segment, m_buffer, second_segment);
+        }
+        else
+        {
+            copyReversed(array, m_buffer, second_segment);
+            copyReversed(array + second_segment, m_buffer + oldest, first_segment);
+        }
     }
 
-    template<class data_t, class uint_t>
-    data_t& Buffer<data_t, uint_t>::operator[](uint_t index)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    data_t& Buffer<data_t, uint_t, N, full_capacity>::operator[](uint_t index)
     {
         return m_buffer[(m_buffer_head - 1 - index) & m_buffer_mask];
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::operator<<(const data_t& value)
+    // The positions are counted from the tail without masking. The newest value is at tail + count - 1
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::iterator Buffer<data_t, uint_t, N, full_capacity>::begin()
+    {
+        return iterator(m_buffer, m_buffer_mask, std::ptrdiff_t(m_buffer_tail) + m_buffer_count - 1);
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::iterator Buffer<data_t, uint_t, N, full_capacity>::end()
+    {
+        return iterator(m_buffer, m_buffer_mask, std::ptrdiff_t(m_buffer_tail) - 1);
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::const_iterator Buffer<data_t, uint_t, N, full_capacity>::cbegin()
+    {
+        return begin();
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::const_iterator Buffer<data_t, uint_t, N, full_capacity>::cend()
+    {
+        return end();
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::reverse_iterator Buffer<data_t, uint_t, N, full_capacity>::rbegin()
+    {
+        return reverse_iterator(m_buffer, m_buffer_mask, std::ptrdiff_t(m_buffer_tail));
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::reverse_iterator Buffer<data_t, uint_t, N, full_capacity>::rend()
+    {
+        return reverse_iterator(m_buffer, m_buffer_mask, std::ptrdiff_t(m_buffer_tail) + m_buffer_count);
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::const_reverse_iterator Buffer<data_t, uint_t, N, full_capacity>::crbegin()
+    {
+        return rbegin();
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    typename Buffer<data_t, uint_t, N, full_capacity>::const_reverse_iterator Buffer<data_t, uint_t, N, full_capacity>::crend()
+    {
+        return rend();
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::operator<<(const data_t& value)
     {
         pushFront(value);
         return *this;
     }
 
-    template<class data_t, class uint_t>
-    Buffer<data_t, uint_t>& Buffer<data_t, uint_t>::operator>>(data_t& value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    Buffer<data_t, uint_t, N, full_capacity>& Buffer<data_t, uint_t, N, full_capacity>::operator>>(data_t& value)
     {
-        popBack(value);
+        popBack(&value);
         return *this;
     }
+
+    // Maximum number of elements. One element less than the memory, unless in full capacity mode
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    uint_t Buffer<data_t, uint_t, N, full_capacity>::capacity()
+    {
+        if constexpr(full_capacity)
+            return m_buffer_mask + 1;
+        else
+            return m_buffer_mask;
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    void Buffer<data_t, uint_t, N, full_capacity>::copy(data_t* dst, const data_t* src, uint_t count)
+    {
+        if constexpr(std::is_trivially_copyable_v<data_t>)
+        {
+            if(count) std::memcpy(dst, src, count * sizeof(data_t));
+        }
+        else
+        {
+            for(uint_t i = 0; i < count; ++i) dst[i] = src[i];
+        }
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity>
+    void Buffer<data_t, uint_t, N, full_capacity>::copyReversed(data_t* dst, const data_t* src, uint_t count)
+    {
+        // Simple loop without index masking, so the compiler is free to vectorize it
+        src += count;
+        for(uint_t i = 0; i < count; ++i) dst[i] = *--src;
+    }
 }
 
 #endif // BUFFER_H
@@ -27,13 +27,26 @@
 #include "movingaverageexp.h"
 #include "movingaveragekaufman.h"
 #include "movingaverageweighted.h"
+#include "multimovingaverage.h"
 #include "movingmedian.h"
-#include "movingmostfrequentoccurrence.h"
+#include "movingmedianheap.h"
+#include "movingmediann.h"
+#include "movingmedianhistogram.h"
+#include "movingmostfrequentoccurance.h"
+#include "movingmostfrequentbin.h"
 #include "movingmiddle.h"
+#include "movingmin.h"
+#include "movingmax.h"
+#include "movingrange.h"
 #include "lowpass.h"
 #include "hipass.h"
+#include "filterbank.h"
+#include "biquad.h"
+#include "soscascade.h"
+#include "multisoscascade.h"
 #include "interpolation.h"
 #include "intervalaverage.h"
 #include "intervalmedian.h"
+#include "filterarena.h"
 
 #endif // FILTER_H
@@ -0,0 +1,286 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Arena for creating many filter objects together with their buffers in one
+ * contiguous block of memory. The memory is passed to the constructor, the same
+ * way as for the buffers. Objects are placed one after the other, so the state
+ * of a stream, the filter object and its buffers, is co-located in memory.
+ * All objects are released at once.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Keep the number of used bytes
+ * 2. To allocate, align the first free byte for the type and move the used
+ *    bytes past the allocation
+ * 3. To release everything, set the used bytes to 0
+ *
+ * PROS
+ * ----
+ * 1. Allocation is a few arithmetic operations, no heap calls
+ * 2. Objects created in sequence are adjacent in memory
+ * 3. Bulk release
+ *
+ * CONS
+ * ----
+ * 1. Single objects can not be released
+ * 2. Destructors are not called on release. The filters hold no resources,
+ *    unless a buffer is constructed with safe_erase set
+ * 3. Not thread safe
+ */
+
+#ifndef FILTERARENA_H
+#define FILTERARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    class FilterArena
+    {
+        public:
+            // Size of an additional buffer of a filter, in elements of aux_t. Passed to createWindowed()
+            template <class aux_t> struct Auxiliary
+            {
+                    std::size_t size;
+            };
+
+        public:
+            /**
+             * @brief FilterArena Construct an arena object
+             * @param memory Pointer to the allocated memory for the arena
+             * @param size The size of the memory in bytes
+             */
+            FilterArena(void *memory, std::size_t size);
+
+            /**
+             * @brief allocate Allocate uninitialized memory for count objects
+             * @return Pointer to the memory or nullptr if the arena is exhausted
+             */
+            template <class data_t> inline data_t* allocate(std::size_t count = 1);
+            /**
+             * @brief create Construct an object in the arena
+             * @return Pointer to the object or nullptr if the arena is exhausted
+             */
+            template <class object_t, class... args_t> inline object_t* create(args_t&&... args);
+            /**
+             * @brief createWindowed Construct a filter followed by its buffer. The filter
+             *        constructor is called with (buffer, buffer_size, args...)
+             * @param buffer_size The number of elements in the buffer
+             * @return Pointer to the filter or nullptr if the arena is exhausted or
+             *         buffer_size does not fit in the uint_t of the filter
+             */
+            template <class filter_t, class data_t, class... args_t> inline filter_t* createWindowed(std::size_t buffer_size, args_t&&... args);
+            /**
+             * @brief createWindowed Construct a filter followed by its buffer and one or two
+             *        additional buffers, e.g. the wedge of MovingMin or the occurrence records and
+             *        the index of MovingMostFrequentOccurrence. The filter constructor is called
+             *        with (buffer, aux1_buffer, [aux2_buffer,] buffer_size, args...)
+             * @param buffer_size The number of elements in the buffer
+             * @param aux1 The number of elements in the first additional buffer
+             * @param aux2 The number of elements in the second additional buffer
+             * @return Pointer to the filter or nullptr if the arena is exhausted or
+             *         buffer_size does not fit in the uint_t of the filter
+             */
+            template <class filter_t, class data_t, class aux1_t, class... args_t> inline filter_t* createWindowed(std::size_t buffer_size, Auxiliary<aux1_t> aux1, args_t&&... args);
+            template <class filter_t, class data_t, class aux1_t, class aux2_t, class... args_t> inline filter_t* createWindowed(std::size_t buffer_size, Auxiliary<aux1_t> aux1, Auxiliary<aux2_t> aux2, args_t&&... args);
+            // Release all objects. Their destructors are not called
+            inline void release();
+            inline std::size_t used();
+            inline std::size_t size();
+            inline bool valid();
+
+        private:
+            // Deduce the uint_t of a filter from its reset(buffer, [aux1_buffer, [aux2_buffer,]] buffer_size, ...)
+            // member. The size is the first unsigned parameter. Declared only, used in decltype
+            template <class data_t, class class_t, class uint_t, class... args_t>
+            static std::enable_if_t<std::is_unsigned_v<uint_t>, uint_t> sizeType(void (class_t::*)(data_t*, uint_t, args_t...));
+            template <class data_t, class aux1_t, class class_t, class uint_t, class... args_t>
+            static std::enable_if_t<std::is_unsigned_v<uint_t>, uint_t> sizeType(void (class_t::*)(data_t*, aux1_t*, uint_t, args_t...));
+            template <class data_t, class aux1_t, class aux2_t, class class_t, class uint_t, class... args_t>
+            static std::enable_if_t<std::is_unsigned_v<uint_t>, uint_t> sizeType(void (class_t::*)(data_t*, aux1_t*, aux2_t*, uint_t, args_t...));
+            // Allocate count objects constructed with their default value
+            template <class data_t> inline data_t* allocateValues(std::size_t count);
+
+        private:
+            unsigned char *m_memory;
+            std::size_t m_size;
+            std::size_t m_used;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    inline FilterArena::FilterArena(void *memory, std::size_t size):
+        m_memory(static_cast<unsigned char*>(memory)),
+        m_size(memory ? size : 0),
+        m_used(0)
+    {
+    }
+
+    template <class data_t>
+    data_t* FilterArena::allocate(std::size_t count)
+    {
+        if(m_memory == nullptr)
+            return nullptr;
+
+        // Align the first free byte for the type
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(m_memory) + m_used;
+        const std::size_t offset = m_used + ((alignof(data_t) - address % alignof(data_t)) % alignof(data_t));
+
+        if(offset > m_size || count > (m_size - offset) / sizeof(data_t))
+            return nullptr;
+
+        m_used = offset + count * sizeof(data_t);
+
+        return reinterpret_cast<data_t*>(m_memory + offset);
+    }
+
+    template <class object_t, class... args_t>
+    object_t* FilterArena::create(args_t&&... args)
+    {
+        object_t *object = allocate<object_t>();
+        if(object == nullptr)
+            return nullptr;
+
+        return new(object) object_t(std::forward<args_t>(args)...);
+    }
+
+    template <class filter_t, class data_t, class... args_t>
+    filter_t* FilterArena::createWindowed(std::size_t buffer_size, args_t&&... args)
+    {
+        static_assert (std::is_constructible_v<filter_t, data_t*, std::size_t, args_t...>, "The filter expected to take (buffer, buffer_size, args...). Pass the sizes of additional buffers as FilterArena::Auxiliary");
+
+        using uint_t = decltype(sizeType<data_t>(&filter_t::reset));
+
+        // The filter would see a truncated size
+        if(buffer_size > std::numeric_limits<uint_t>::max())
+            return nullptr;
+
+        const std::size_t used = m_used;
+
+        // The buffer is placed right after the filter object
+        filter_t *filter = allocate<filter_t>();
+        data_t *buffer = allocateValues<data_t>(buffer_size);
+        if(filter == nullptr || buffer == nullptr)
+        {
+            m_used = used;
+            return nullptr;
+        }
+
+        return new(filter) filter_t(buffer, uint_t(buffer_size), std::forward<args_t>(args)...);
+    }
+
+    template <class filter_t, class data_t, class aux1_t, class... args_t>
+    filter_t* FilterArena::createWindowed(std::size_t buffer_size, Auxiliary<aux1_t> aux1, args_t&&... args)
+    {
+        static_assert (std::is_constructible_v<filter_t, data_t*, aux1_t*, std::size_t, args_t...>, "The filter expected to take (buffer, aux1_buffer, buffer_size, args...)");
+
+        using uint_t = decltype(sizeType<data_t, aux1_t>(&filter_t::reset));
+
+        if(buffer_size > std::numeric_limits<uint_t>::max())
+            return nullptr;
+
+        const std::size_t used = m_used;
+
+        filter_t *filter = allocate<filter_t>();
+        data_t *buffer = allocateValues<data_t>(buffer_size);
+        aux1_t *aux1_buffer = allocateValues<aux1_t>(aux1.size);
+        if(filter == nullptr || buffer == nullptr || aux1_buffer == nullptr)
+        {
+            m_used = used;
+            return nullptr;
+        }
+
+        return new(filter) filter_t(buffer, aux1_buffer, uint_t(buffer_size), std::forward<args_t>(args)...);
+    }
+
+    template <class filter_t, class data_t, class aux1_t, class aux2_t, class... args_t>
+    filter_t* FilterArena::createWindowed(std::size_t buffer_size, Auxiliary<aux1_t> aux1, Auxiliary<aux2_t> aux2, args_t&&... args)
+    {
+        static_assert (std::is_constructible_v<filter_t, data_t*, aux1_t*, aux2_t*, std::size_t, args_t...>, "The filter expected to take (buffer, aux1_buffer, aux2_buffer, buffer_size, args...)");
+
+        using uint_t = decltype(sizeType<data_t, aux1_t, aux2_t>(&filter_t::reset));
+
+        if(buffer_size > std::numeric_limits<uint_t>::max())
+            return nullptr;
+
+        const std::size_t used = m_used;
+
+        filter_t *filter = allocate<filter_t>();
+        data_t *buffer = allocateValues<data_t>(buffer_size);
+        aux1_t *aux1_buffer = allocateValues<aux1_t>(aux1.size);
+        aux2_t *aux2_buffer = allocateValues<aux2_t>(aux2.size);
+        if(filter == nullptr || buffer == nullptr || aux1_buffer == nullptr || aux2_buffer == nullptr)
+        {
+            m_used = used;
+            return nullptr;
+        }
+
+        return new(filter) filter_t(buffer, aux1_buffer, aux2_buffer, uint_t(buffer_size), std::forward<args_t>(args)...);
+    }
+
+    template <class data_t>
+    data_t* FilterArena::allocateValues(std::size_t count)
+    {
+        data_t *values = allocate<data_t>(count);
+        if(values == nullptr)
+            return nullptr;
+
+        for(std::size_t i = 0; i < count; ++i) new(values + i) data_t();
+
+        return values;
+    }
+
+    void FilterArena::release()
+    {
+        m_used = 0;
+    }
+
+    std::size_t FilterArena::used()
+    {
+        return m_used;
+    }
+
+    std::size_t FilterArena::size()
+    {
+        return m_size;
+    }
+
+    bool FilterArena::valid()
+    {
+        return m_memory != nullptr;
+    }
+}
+
+#endif // FILTERARENA_H
@@ -0,0 +1,253 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Bank of many independent Low Pass or Exponential Moving Average channels, updated
+ * together. Every channel gives the same result as a LowPass or ExpMovingAverage
+ * object with the same parameters. Both filters share the recurrence
+ * y[i] := y[i-1] + α * (x[i] - y[i-1]), only α is calculated differently.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. The state, α and the warm-up counter of all channels are kept in separate arrays
+ *    (structure of arrays), so the same operation on consecutive channels is done on
+ *    consecutive memory
+ * 2. in() takes one value per channel. While some channels are still skipping their
+ *    first values, a skipping channel takes the new value as its previous state, so
+ *    the recurrence returns the new value and all channels run the same code. Once
+ *    all channels are warmed up, the loop is the bare recurrence
+ * 3. Both loops have no branches and no dependencies between the channels, so the
+ *    compiler vectorizes them. Enable the target instruction set, e.g. -mavx2 or
+ *    -mavx512f, to update 8 or 16 float channels with one instruction. GCC keeps
+ *    the warm-up loop scalar for 32-bit integer data_t, because the conversion to
+ *    float may raise an exception, unless -fno-trapping-math is set
+ *
+ * PROS
+ * ----
+ * 1. Fast update of many channels
+ * 2. Compact memory, three arrays for any number of channels
+ *
+ * CONS
+ * ----
+ * 1. All channels are updated on every tick
+ * 2. The results are identical to the scalar filters only if both are compiled
+ *    with the same floating point contraction settings (-ffp-contract)
+ * 3. A skipped floating point value of -0.0 is stored as +0.0, and a skipped infinity
+ *    as NaN, because the new value is subtracted from itself
+ *
+ * TYPE
+ * ----
+ * IIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef FILTERBANK_H
+#define FILTERBANK_H
+
+#include <type_traits>
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class FilterBank
+    {
+        public:
+            /**
+             * @brief FilterBank Construct a filter bank. All channels pass the values through
+             *        until they are set with setLowPass() or setExpMovingAverage()
+             * @param state Pointer to the allocated memory for the filtered values
+             * @param alpha Pointer to the allocated memory for the coefficients
+             * @param first_value_offset Pointer to the allocated memory for the warm-up counters
+             * @param channels The number of channels. Every buffer must hold this many elements
+             */
+            FilterBank(data_t *state, float *alpha, uint_t *first_value_offset, uint_t channels);
+            // Same parameters as the LowPass constructor
+            void setLowPass(uint_t channel, float alpha, uint_t first_value_offset = 0);
+            // Same parameters as the ExpMovingAverage constructor
+            void setExpMovingAverage(uint_t channel, uint_t periods, uint_t first_value_offset = 0);
+            // Write the filtered value of every channel to values
+            void out(data_t *values);
+            data_t out(uint_t channel);
+            // Feed one value per channel
+            void in(const data_t *values);
+            /**
+             * @brief process Filter a block of ticks. Same result as calling in() and out()
+             *                for every tick
+             * @param src Pointer to the values, one value per channel for every tick
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param ticks Number of ticks
+             */
+            void process(const data_t *src, data_t *dst, uint_t ticks);
+            void reset();
+            bool valid();
+
+        private:
+            void set(uint_t channel, float alpha, uint_t first_value_offset);
+
+        private:
+            data_t *m_state;
+            float  *m_alpha;
+            uint_t *m_first_value_offset;
+            uint_t m_channels;
+            // Number of channels that still skip their first values
+            uint_t m_warming_up;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t>
+    FilterBank<data_t, uint_t>::FilterBank(data_t *state, float *alpha, uint_t *first_value_offset, uint_t channels):
+        m_state(state),
+        m_alpha(alpha),
+        m_first_value_offset(first_value_offset),
+        m_channels((state && alpha && first_value_offset) ? channels : 0),
+        m_warming_up(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+
+        // A Low Pass with α = 1 passes the values through
+        for(uint_t channel = 0; channel < m_channels; ++channel)
+        {
+            m_state[channel] = data_t();
+            m_alpha[channel] = 1.0F;
+            m_first_value_offset[channel] = 1;
+        }
+        m_warming_up = m_channels;
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::setLowPass(uint_t channel, float alpha, uint_t first_value_offset)
+    {
+        set(channel, alpha, first_value_offset);
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::setExpMovingAverage(uint_t channel, uint_t periods, uint_t first_value_offset)
+    {
+        set(channel, 2.0F / (periods + 1), first_value_offset);
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::out(data_t *values)
+    {
+        for(uint_t channel = 0; channel < m_channels; ++channel) values[channel] = m_state[channel];
+    }
+
+    template <class data_t, class uint_t>
+    data_t FilterBank<data_t, uint_t>::out(uint_t channel)
+    {
+        if(channel >= m_channels)
+            return data_t();
+
+        return m_state[channel];
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::in(const data_t *values)
+    {
+        data_t *state = m_state;
+        const float *alpha = m_alpha;
+        const uint_t channels = m_channels;
+
+        if(m_warming_up == 0)
+        {
+            // Same expression as in LowPass::in()
+            for(uint_t channel = 0; channel < channels; ++channel)
+                state[channel] = state[channel] + alpha[channel] * (values[channel] - state[channel]);
+            return;
+        }
+
+        uint_t *first_value_offset = m_first_value_offset;
+        uint_t warming_up = 0;
+        for(uint_t channel = 0; channel < channels; ++channel)
+        {
+            const data_t value = values[channel];
+            const uint_t offset = first_value_offset[channel];
+            const bool skip = offset != 0;
+
+            // A skipping channel filters from its own value, which gives the value back. Selecting
+            // the result instead lets the compiler move the calculation into a branch
+            const data_t previous = skip ? value : state[channel];
+            state[channel] = previous + alpha[channel] * (value - previous);
+
+            const uint_t next_offset = offset - skip;
+            first_value_offset[channel] = next_offset;
+            warming_up += next_offset != 0;
+        }
+        m_warming_up = warming_up;
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::process(const data_t *src, data_t *dst, uint_t ticks)
+    {
+        for(uint_t tick = 0; tick < ticks; ++tick)
+        {
+            in(src);
+            out(dst);
+            src += m_channels;
+            dst += m_channels;
+        }
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::reset()
+    {
+        for(uint_t channel = 0; channel < m_channels; ++channel) m_state[channel] = data_t();
+    }
+
+    template <class data_t, class uint_t>
+    bool FilterBank<data_t, uint_t>::valid()
+    {
+        return m_channels != 0;
+    }
+
+    template <class data_t, class uint_t>
+    void FilterBank<data_t, uint_t>::set(uint_t channel, float alpha, uint_t first_value_offset)
+    {
+        if(channel >= m_channels)
+            return;
+
+        // Same initial state as the scalar filters
+        if(m_first_value_offset[channel] == 0)
+            ++m_warming_up;
+
+        m_state[channel] = data_t();
+        m_alpha[channel] = alpha;
+        m_first_value_offset[channel] = ++first_value_offset;
+    }
+}
+
+#endif // FILTERBANK_H
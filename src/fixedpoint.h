@@ -0,0 +1,132 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Fixed point coefficients for the IIR filters. A filter with integer data can
+ * take its coefficient as Q15 (q15_t) or Q31 (q31_t) instead of float. The value
+ * is then multiplied by the coefficient in a wider integer type and shifted back,
+ * so there are no conversions to float and the results are the same on every
+ * platform.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. A Qn coefficient c represents the real number c / 2^n
+ * 2. value * c is calculated in a signed integer type wide enough for the product
+ * 3. The product is rounded to the nearest integer by adding 2^(n-1) and shifting
+ *    right by n bits. Halves are rounded up
+ * 4. The result is saturated to the range of the data type
+ *
+ * DATA TYPES
+ * ----------
+ * coeff_t - Type of the coefficient. q15_t or q31_t
+ */
+
+#ifndef FIXEDPOINT_H
+#define FIXEDPOINT_H
+
+#include <type_traits>
+#include <cstdint>
+#include <limits>
+
+namespace filter
+{
+    // Coefficient in the range [-1, 1) with 15 fractional bits
+    using q15_t = std::int16_t;
+    // Coefficient in the range [-1, 1) with 31 fractional bits
+    using q31_t = std::int32_t;
+
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class coeff_t>
+    struct FixedPoint
+    {
+        static_assert (std::is_same_v<coeff_t, q15_t> || std::is_same_v<coeff_t, q31_t>, "Template type \"coeff_t\" expected to be q15_t or q31_t");
+
+        static constexpr unsigned int frac_bits = sizeof(coeff_t) * 8 - 1;
+
+        // Signed integer type that holds the product of a coefficient and a value of value_bits bits
+        template <unsigned int value_bits>
+        using product_t = std::conditional_t<value_bits + frac_bits <= 32, std::int32_t, std::int64_t>;
+
+        // Convert a real number to a coefficient. Out of range values are saturated
+        static constexpr coeff_t fromFloat(double value);
+        // Convert numerator / denominator to a coefficient, without floating point. Out of range
+        // values are saturated. The numerator must be less than 2^32
+        static constexpr coeff_t fromRatio(std::uint64_t numerator, std::uint64_t denominator);
+        // value * coeff, rounded to the nearest integer
+        template <class value_t> static constexpr value_t multiply(value_t value, coeff_t coeff);
+        // Limit value to the range of data_t
+        template <class data_t, class value_t> static constexpr data_t saturate(value_t value);
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template <class coeff_t>
+    constexpr coeff_t FixedPoint<coeff_t>::fromFloat(double value)
+    {
+        const double scaled = value * double(std::int64_t(1) << frac_bits);
+
+        if(scaled >= double(std::numeric_limits<coeff_t>::max())) return std::numeric_limits<coeff_t>::max();
+        if(scaled <= double(std::numeric_limits<coeff_t>::min())) return std::numeric_limits<coeff_t>::min();
+
+        return coeff_t(scaled < 0 ? scaled - 0.5 : scaled + 0.5);
+    }
+
+    template <class coeff_t>
+    constexpr coeff_t FixedPoint<coeff_t>::fromRatio(std::uint64_t numerator, std::uint64_t denominator)
+    {
+        if(denominator == 0)
+            return std::numeric_limits<coeff_t>::max();
+
+        const std::uint64_t quotient = ((numerator << frac_bits) + denominator / 2) / denominator;
+        if(quotient > std::uint64_t(std::numeric_limits<coeff_t>::max()))
+            return std::numeric_limits<coeff_t>::max();
+
+        return coeff_t(quotient);
+    }
+
+    template <class coeff_t>
+    template <class value_t>
+    constexpr value_t FixedPoint<coeff_t>::multiply(value_t value, coeff_t coeff)
+    {
+        static_assert (std::is_signed_v<value_t> && sizeof(value_t) > sizeof(coeff_t), "Template type \"value_t\" expected to be a wider signed integer");
+
+        return (value * coeff + (value_t(1) << (frac_bits - 1))) >> frac_bits;
+    }
+
+    template <class coeff_t>
+    template <class data_t, class value_t>
+    constexpr data_t FixedPoint<coeff_t>::saturate(value_t value)
+    {
+        if(value < value_t(std::numeric_limits<data_t>::min())) return std::numeric_limits<data_t>::min();
+        if(value > value_t(std::numeric_limits<data_t>::max())) return std::numeric_limits<data_t>::max();
+
+        return data_t(value);
+    }
+}
+
+#endif // FIXEDPOINT_H
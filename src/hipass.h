@@ -46,12 +46,15 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * coeff_t - Type of the coefficient. float, or q15_t/q31_t for fixed point
+ *           arithmetic with integer data_t. See fixedpoint.h
  */
 
 #ifndef HIPASS_H
 #define HIPASS_H
 
 #include <type_traits>
+#include "fixedpoint.h"
 
 namespace filter
 {
@@ -59,49 +62,67 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
+    template <class data_t, class uint_t = unsigned short int, class coeff_t = float>
     class HiPass
     {
         public:
-            HiPass(float alpha, uint_t offset = 0);
+            HiPass(coeff_t alpha, uint_t offset = 0);
             data_t out();
             void in(const data_t& value);
-            void reset(float alpha, uint_t offset);
+            /**
+             * @brief process Filter a block of values. Same result as calling in() and out()
+             *                for every value
+             * @param src Pointer to the values
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param count Number of values
+             */
+            void process(const data_t *src, data_t *dst, uint_t count);
+            void reset(coeff_t alpha, uint_t offset);
             void reset();
 
+        private:
+            static inline data_t step(const data_t& hipass, const data_t& value, const data_t& value_last, const coeff_t& alpha);
+
         private:
             data_t m_hipass;
-            float  m_alpha;
+            coeff_t m_alpha;
             uint_t m_first_value_offset;
             data_t m_value_last;
     };
 
+    // HiPass with fixed point coefficient
+    template <class data_t, class uint_t = unsigned short int>
+    using HiPassQ15 = HiPass<data_t, uint_t, q15_t>;
+    template <class data_t, class uint_t = unsigned short int>
+    using HiPassQ31 = HiPass<data_t, uint_t, q31_t>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t>
-    HiPass<data_t, uint_t>::HiPass(float alpha, uint_t offset):
+    template <class data_t, class uint_t, class coeff_t>
+    HiPass<data_t, uint_t, coeff_t>::HiPass(coeff_t alpha, uint_t offset):
         m_hipass(data_t()),
         m_alpha(alpha),
         m_first_value_offset(offset + 2),
         m_value_last(data_t())
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_floating_point_v<coeff_t> || (std::is_integral_v<data_t> && sizeof(data_t) * 8 + 2 + sizeof(coeff_t) * 8 - 1 <= 64), "Template type \"data_t\" expected to be an integer of up to 32 bits for q15_t or 16 bits for q31_t coefficient");
     }
 
-    template <class data_t, class uint_t>
-    data_t HiPass<data_t, uint_t>::out()
+    template <class data_t, class uint_t, class coeff_t>
+    data_t HiPass<data_t, uint_t, coeff_t>::out()
     {
         return m_hipass;
     }
 
-    template <class data_t, class uint_t>
-    void HiPass<data_t, uint_t>::in(const data_t& value)
+    template <class data_t, class uint_t, class coeff_t>
+    void HiPass<data_t, uint_t, coeff_t>::in(const data_t& value)
     {
         if(m_first_value_offset == 0)
         {
-            m_hipass = m_alpha * (m_hipass + value - m_value_last); //Refactored from [m_alpha * m_hipass + m_alpha * (value - m_value_last)]
+            m_hipass = step(m_hipass, value, m_value_last, m_alpha);
             m_value_last = value;
         }
         else
@@ -112,8 +133,37 @@ namespace filter
         }
     }
 
-    template <class data_t, class uint_t>
-    void HiPass<data_t, uint_t>::reset(float alpha, uint_t offset)
+    template <class data_t, class uint_t, class coeff_t>
+    void HiPass<data_t, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t count)
+    {
+        uint_t i = 0;
+
+        // The first values are passed through
+        for(; i < count && m_first_value_offset != 0; ++i)
+        {
+            --m_first_value_offset;
+            m_value_last = m_hipass;
+            m_hipass = src[i];
+            dst[i] = m_hipass;
+        }
+
+        // Keep the state in local variables, so it is not reloaded after every store to dst
+        const coeff_t alpha = m_alpha;
+        data_t hipass = m_hipass;
+        data_t value_last = m_value_last;
+        for(; i < count; ++i)
+        {
+            const data_t value = src[i];
+            hipass = step(hipass, value, value_last, alpha);
+            value_last = value;
+            dst[i] = hipass;
+        }
+        m_hipass = hipass;
+        m_value_last = value_last;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void HiPass<data_t, uint_t, coeff_t>::reset(coeff_t alpha, uint_t offset)
     {
         m_hipass = data_t();
         m_alpha = alpha;
@@ -121,12 +171,29 @@ namespace filter
         m_value_last = data_t();
     }
 
-    template <class data_t, class uint_t>
-    void HiPass<data_t, uint_t>::reset()
+    template <class data_t, class uint_t, class coeff_t>
+    void HiPass<data_t, uint_t, coeff_t>::reset()
     {
         m_hipass = data_t();
         m_value_last = data_t();
     }
+
+    template <class data_t, class uint_t, class coeff_t>
+    data_t HiPass<data_t, uint_t, coeff_t>::step(const data_t& hipass, const data_t& value, const data_t& value_last, const coeff_t& alpha)
+    {
+        if constexpr(std::is_floating_point_v<coeff_t>)
+        {
+            return alpha * (hipass + value - value_last); //Refactored from [alpha * hipass + alpha * (value - value_last)]
+        }
+        else
+        {
+            // The sum of three values needs two bits more than data_t
+            using Fixed = FixedPoint<coeff_t>;
+            using product_t = typename Fixed::template product_t<sizeof(data_t) * 8 + 2>;
+
+            return Fixed::template saturate<data_t>(Fixed::multiply(product_t(hipass) + product_t(value) - product_t(value_last), alpha));
+        }
+    }
 }
 
 #endif // HIPASS_H
@@ -66,11 +66,16 @@ namespace filter
             void reset(uint_t interval);
             void reset();
 
+        private:
+            inline void updateShift();
+            inline data_t divideByShift(const data_t& value);
+
         private:
             data_t m_sum;
             data_t m_avg;
             uint_t m_interval;
             uint_t m_count;
+            unsigned char m_shift;
     };
 
     /***********************************************************************/
@@ -82,9 +87,12 @@ namespace filter
         m_sum(data_t()),
         m_avg(data_t()),
         m_interval(interval),
-        m_count(0)
+        m_count(0),
+        m_shift(0)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+
+        updateShift();
     }
 
     template <class data_t, class uint_t>
@@ -100,7 +108,11 @@ namespace filter
         ++m_count;
         if(m_count==m_interval)
         {
-            m_avg = m_sum/m_interval;
+            // An interval of a power of two values is averaged with a shift
+            if constexpr(std::is_integral_v<data_t>)
+                m_avg = (m_interval & (m_interval - 1)) ? data_t(m_sum/m_interval) : divideByShift(m_sum);
+            else
+                m_avg = m_sum/m_interval;
             m_count = 0;
             m_sum = data_t();
         }
@@ -113,6 +125,7 @@ namespace filter
         m_avg = data_t();
         m_interval = interval;
         m_count = 0;
+        updateShift();
     }
 
     template <class data_t, class uint_t>
@@ -122,6 +135,28 @@ namespace filter
         m_avg = data_t();
         m_count = 0;
     }
+
+    template <class data_t, class uint_t>
+    void IntervalAverage<data_t, uint_t>::updateShift()
+    {
+        m_shift = 0;
+        while((1UL << m_shift) < m_interval) ++m_shift;
+    }
+
+    // Same result as dividing by 2^m_shift, including the rounding toward zero of negative values
+    template <class data_t, class uint_t>
+    data_t IntervalAverage<data_t, uint_t>::divideByShift(const data_t& value)
+    {
+        if constexpr(std::is_signed_v<data_t>)
+        {
+            const data_t bias = (value >> (sizeof(data_t) * 8 - 1)) & ((data_t(1) << m_shift) - 1);
+            return (value + bias) >> m_shift;
+        }
+        else
+        {
+            return value >> m_shift;
+        }
+    }
 }
 
 #endif // INTERVALAVERAGE_H
@@ -26,25 +26,33 @@
  *
  * ALGORITHM
  * ---------
- * 1. Calculate the index of the median
- * 2. For every element loop trough all the elements. This require two loops: outer and inner.
- *    In the inner loop count those that are less and those that are equal to the current.
- *    This will give us the exact position of the element/s in the buffer.
- * 3. In the outer loop test if the median index is between the count of the lesser elements and
- *    the count of lesser elements plus the count of the same element. If this is the case then
- *    this is the median and break out of the loop
- * 4. To speed up the algorithm even further, in the outer loop if the element is on the left side
- *    or on the right side of the median skip lesser and greater elements
+ * 1. Collect values until the buffer is full. The buffer is cleared after every interval,
+ *    so the collected values always occupy the first slots of the buffer storage.
+ * 2. Calculate the index of the median
+ * 3. Partition the values in place around a pivot, chosen as the median of the first,
+ *    middle and last values of the current range (Hoare partition scheme)
+ * 4. Continue only with the part that contains the median index, until the range
+ *    shrinks to a single element. This is the median
+ * 5. Introselect: after 2 * log2(count) partitions the pivots are taken as bad, e.g.
+ *    for median of three killer inputs. The rest of the range is then solved with a
+ *    heap selection, which keeps the smallest values up to the median index in a max
+ *    heap built in place at the beginning of the range
+ * 6. Clear the buffer. The order of the values is destroyed by the partitioning,
+ *    but they are not needed anymore
  *
  * PROS
  * ----
  * 1. The returned value is a value from the buffer
  * 2. Remove outliers
  * 3. Faster than the moving median, because the calculation is done only once when the buffer is full
+ * 4. Linear expected time per interval and O(N log N) in the worst case. Large intervals are practical
  *
  * CONS
  * ----
- * 1. Slow
+ * 1. All the work is done on the value that completes the interval
+ * 2. Hand written introselect instead of std::nth_element, so the header does not
+ *    depend on <algorithm>. The heap fallback is slower than the partitioning, but it
+ *    is reached only by adversarial inputs
  *
  * TYPE
  * ----
@@ -57,12 +65,14 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * N      - Size of the embedded buffer. If 0, the buffer is passed to the constructor
  */
 
 #ifndef INTERVALMEDIAN_H
 #define INTERVALMEDIAN_H
 
 #include <type_traits>
+#include <cstddef>
 #include "buffer.h"
 
 namespace filter
@@ -71,12 +81,13 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
-    class IntervalMedian: protected buffer::Buffer<data_t, uint_t>
+    template <class data_t, class uint_t = unsigned short int, unsigned int N = 0>
+    class IntervalMedian: protected buffer::Buffer<data_t, uint_t, N>
     {
-            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using Buffer = buffer::Buffer<data_t, uint_t, N>;
 
         public:
+            IntervalMedian();
             IntervalMedian(data_t *buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
@@ -85,30 +96,47 @@ namespace filter
 
             using Buffer::valid;
 
+        private:
+            data_t select(data_t *array, uint_t count);
+            static inline data_t heapSelect(data_t *array, std::ptrdiff_t count, std::ptrdiff_t index);
+
         private:
             data_t m_median;
     };
 
+    // IntervalMedian with embedded buffer of N elements
+    template <class data_t, unsigned int N, class uint_t = unsigned short int>
+    using StaticIntervalMedian = IntervalMedian<data_t, uint_t, N>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    IntervalMedian<data_t, uint_t>::IntervalMedian(data_t *buffer, uint_t buffer_size):
+    template<class data_t, class uint_t, unsigned int N>
+    IntervalMedian<data_t, uint_t, N>::IntervalMedian():
+        Buffer(),
+        m_median(data_t())
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (N != 0, "Template parameter \"N\" expected to be the size of the embedded buffer");
+    }
+
+    template<class data_t, class uint_t, unsigned int N>
+    IntervalMedian<data_t, uint_t, N>::IntervalMedian(data_t *buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size),
         m_median(data_t())
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
     }
 
-    template<class data_t, class uint_t>
-    data_t IntervalMedian<data_t, uint_t>::out()
+    template<class data_t, class uint_t, unsigned int N>
+    data_t IntervalMedian<data_t, uint_t, N>::out()
     {
         return m_median;
     }
 
-    template<class data_t, class uint_t>
-    void IntervalMedian<data_t, uint_t>::in(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N>
+    void IntervalMedian<data_t, uint_t, N>::in(const data_t& value)
     {
         if(!Buffer::valid()) return;
 
@@ -116,91 +144,111 @@ namespace filter
 
         if(Buffer::full())
         {
-            uint_t buffer_size = Buffer::size();
-
-            // 1. Calculate the index of the median
-            uint_t middle_index = buffer_size/2;
-            data_t skip_greater_than;
-            data_t skip_lesser_than;
-            bool skip_greater_than_found = false;
-            bool skip_lesser_than_found = false;
+            // The buffer is cleared after every interval, so the values are stored contiguously from the last one
+            m_median = select(&Buffer::operator[](Buffer::count() - 1), Buffer::count());
+            Buffer::clear();
+        }
+    }
 
-            // 2. Loop trough all the elements
-            for(uint_t i = 0; i < buffer_size; ++i)
-            {
-                data_t cur_element = Buffer::at(i);
+    template<class data_t, class uint_t, unsigned int N>
+    void IntervalMedian<data_t, uint_t, N>::reset(data_t *buffer, uint_t buffer_size)
+    {
+        m_median = data_t();
+        Buffer::init(buffer, buffer_size);
+    }
 
-                // 5. To speed up the algirithm, if the element is on the right side of the median, skip all greater elements
-                if(skip_greater_than_found && cur_element >= skip_greater_than) continue;
-                // 5. To speed up the algirithm, if the element is on the left side of the median, skip all lesser elements
-                if(skip_lesser_than_found && cur_element <= skip_lesser_than) continue;
+    template<class data_t, class uint_t, unsigned int N>
+    void IntervalMedian<data_t, uint_t, N>::reset()
+    {
+        m_median = data_t();
+        Buffer::clear();
+    }
 
-                uint_t left_index= 0;
-                uint_t right_index = 0;
+    template<class data_t, class uint_t, unsigned int N>
+    data_t IntervalMedian<data_t, uint_t, N>::select(data_t *array, uint_t count)
+    {
+        // 2. Calculate the index of the median
+        const std::ptrdiff_t middle_index = count / 2;
+        std::ptrdiff_t left = 0;
+        std::ptrdiff_t right = std::ptrdiff_t(count) - 1;
 
-                /* 3. Count the smaller elements and those that are equal. That way we find the
-                 *    first and the last index. Since the inner loop does not skip if the current element pass by itself,
-                 *    it is counted twice and the right index can be calculated by subtracting 1
-                 */
-                for(uint_t j = 0; j < buffer_size; ++j)
-                {
-                    data_t cmp_element = Buffer::at(j);
-
-                    if(cmp_element < cur_element)
-                    {
-                        ++left_index;
-                        ++right_index;
-                    }
-                    /* We have to take into account that the inner loop does not skip an itteration
-                     * when it pass by itself, thus the right index is allways +1. When we test
-                     * at step (4.) we must take this into account and use the < sign and not <=
-                     */
-                    else if(cmp_element == cur_element) ++right_index;
-                }
+        // 5. Number of partitions before the heap selection takes over
+        unsigned int depth_limit = 0;
+        for(uint_t n = count; n > 1; n /= 2) depth_limit += 2;
 
-                // 4. If this is the median break out of the loop and return it
-                if(left_index <= middle_index && middle_index < right_index)
-                {
-                    m_median = cur_element;
-                    break;
-                }
-                // 5. If the element is on the right side of the median, skip all others greater than it
-                else if(middle_index < left_index)
-                {
-                    if(skip_greater_than_found) skip_greater_than = cur_element;
-                    else
-                    {
-                        skip_greater_than_found = true;
-                        skip_greater_than = cur_element;
-                    }
-                }
-                // 5. If the element is on the left side of the median, skip all others lesser than it
-                else if(middle_index >= right_index)
+        while(left < right)
+        {
+            if(depth_limit-- == 0)
+                return heapSelect(array + left, right - left + 1, middle_index - left);
+
+            // 3. Median of three pivot. It is a value from the range, so the scans below can not run past its ends
+            const data_t &a = array[left];
+            const data_t &b = array[middle_index];
+            const data_t &c = array[right];
+            const data_t pivot = (a < b) ? ((b < c) ? b : ((a < c) ? c : a)) : ((a < c) ? a : ((b < c) ? c : b));
+
+            std::ptrdiff_t i = left;
+            std::ptrdiff_t j = right;
+            do
+            {
+                while(array[i] < pivot) ++i;
+                while(pivot < array[j]) --j;
+                if(i <= j)
                 {
-                    if(skip_lesser_than_found) skip_lesser_than = cur_element;
-                    else
-                    {
-                        skip_lesser_than_found = true;
-                        skip_lesser_than = cur_element;
-                    }
+                    const data_t tmp_swap = array[i];
+                    array[i] = array[j];
+                    array[j] = tmp_swap;
+                    ++i;
+                    --j;
                 }
             }
-            Buffer::clear();
+            while(i <= j);
+
+            // 4. Continue with the part that contains the median index
+            if(j < middle_index) left = i;
+            if(middle_index < i) right = j;
         }
-    }
 
-    template<class data_t, class uint_t>
-    void IntervalMedian<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size)
-    {
-        m_median = data_t();
-        Buffer::init(buffer, buffer_size);
+        return array[middle_index];
     }
 
-    template<class data_t, class uint_t>
-    void IntervalMedian<data_t, uint_t>::reset()
+    // The value at the index, if the array was sorted. The array is reordered
+    template<class data_t, class uint_t, unsigned int N>
+    data_t IntervalMedian<data_t, uint_t, N>::heapSelect(data_t *array, std::ptrdiff_t count, std::ptrdiff_t index)
     {
-        m_median = data_t();
-        Buffer::clear();
+        const std::ptrdiff_t heap_size = index + 1;
+
+        // Move the value at the root down until both children are not greater
+        auto siftDown = [array, heap_size](std::ptrdiff_t parent)
+        {
+            const data_t value = array[parent];
+            for(std::ptrdiff_t child = 2 * parent + 1; child < heap_size; child = 2 * parent + 1)
+            {
+                if(child + 1 < heap_size && array[child] < array[child + 1]) ++child;
+                if(!(value < array[child])) break;
+
+                array[parent] = array[child];
+                parent = child;
+            }
+            array[parent] = value;
+        };
+
+        // Max heap of the first index + 1 values
+        for(std::ptrdiff_t parent = heap_size / 2; parent-- > 0;) siftDown(parent);
+
+        // Keep the index + 1 smallest values in the heap. Its root is the wanted value
+        for(std::ptrdiff_t i = heap_size; i < count; ++i)
+        {
+            if(array[i] < array[0])
+            {
+                const data_t tmp_swap = array[0];
+                array[0] = array[i];
+                array[i] = tmp_swap;
+                siftDown(0);
+            }
+        }
+
+        return array[0];
     }
 }
 
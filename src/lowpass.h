@@ -43,12 +43,16 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * coeff_t - Type of the coefficient. float, or q15_t/q31_t for fixed point
+ *           arithmetic with integer data_t. See fixedpoint.h
  */
 
 #ifndef LOWPASS_H
 #define LOWPASS_H
 
 #include <type_traits>
+#include <cstddef>
+#include "fixedpoint.h"
 
 namespace filter
 {
@@ -56,7 +60,7 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
+    template <class data_t, class uint_t = unsigned short int, class coeff_t = float>
     class LowPass
     {
         public:
@@ -65,42 +69,64 @@ namespace filter
              * @param alpha Alpha coefficient
              * @param first_value_offset Skip first N values
              */
-            LowPass(float alpha, uint_t first_value_offset = 0);
+            LowPass(coeff_t alpha, uint_t first_value_offset = 0);
             data_t out();
             void in(const data_t& value);
-            void reset(float alpha, uint_t first_value_offset);
+            /**
+             * @brief process Filter a block of values. Same result as calling in() and out()
+             *                for every value
+             * @param src Pointer to the values
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param count Number of values
+             */
+            void process(const data_t *src, data_t *dst, uint_t count);
+            void reset(coeff_t alpha, uint_t first_value_offset);
             void reset();
 
+        private:
+            // Filtering on several threads, see parallelscan.h
+            template <class d_t, class u_t, class c_t>
+            friend void processParallel(LowPass<d_t, u_t, c_t> &filter, const d_t *src, d_t *dst, std::size_t count, unsigned int threads);
+
+            static inline data_t step(const data_t& lowpass, const data_t& value, const coeff_t& alpha);
+
         private:
             data_t m_lowpass;
-            float  m_alpha;
+            coeff_t m_alpha;
             uint_t m_first_value_offset;
     };
 
+    // LowPass with fixed point coefficient
+    template <class data_t, class uint_t = unsigned short int>
+    using LowPassQ15 = LowPass<data_t, uint_t, q15_t>;
+    template <class data_t, class uint_t = unsigned short int>
+    using LowPassQ31 = LowPass<data_t, uint_t, q31_t>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t>
-    LowPass<data_t, uint_t>::LowPass(float alpha, uint_t first_value_offset):
+    template <class data_t, class uint_t, class coeff_t>
+    LowPass<data_t, uint_t, coeff_t>::LowPass(coeff_t alpha, uint_t first_value_offset):
         m_lowpass(data_t()),
         m_alpha(alpha),
         m_first_value_offset(++first_value_offset)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_floating_point_v<coeff_t> || (std::is_integral_v<data_t> && sizeof(data_t) <= 4), "Template type \"data_t\" expected to be an integer of up to 32 bits for fixed point coefficient");
     }
 
-    template <class data_t, class uint_t>
-    data_t LowPass<data_t, uint_t>::out()
+    template <class data_t, class uint_t, class coeff_t>
+    data_t LowPass<data_t, uint_t, coeff_t>::out()
     {
         return m_lowpass;
     }
 
-    template <class data_t, class uint_t>
-    void LowPass<data_t, uint_t>::in(const data_t& value)
+    template <class data_t, class uint_t, class coeff_t>
+    void LowPass<data_t, uint_t, coeff_t>::in(const data_t& value)
     {
         if(m_first_value_offset == 0)
-            m_lowpass = m_lowpass + m_alpha * (value - m_lowpass); //Refactored from [m_alpha * value + (1.0F - m_alpha) * m_lowpass]
+            m_lowpass = step(m_lowpass, value, m_alpha);
         else
         {
             --m_first_value_offset;
@@ -108,19 +134,60 @@ namespace filter
         }
     }
 
-    template <class data_t, class uint_t>
-    void LowPass<data_t, uint_t>::reset(float alpha, uint_t first_value_offset)
+    template <class data_t, class uint_t, class coeff_t>
+    void LowPass<data_t, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t count)
+    {
+        uint_t i = 0;
+
+        // The first values are passed through
+        for(; i < count && m_first_value_offset != 0; ++i)
+        {
+            --m_first_value_offset;
+            m_lowpass = src[i];
+            dst[i] = m_lowpass;
+        }
+
+        // Keep the state in local variables, so it is not reloaded after every store to dst
+        const coeff_t alpha = m_alpha;
+        data_t lowpass = m_lowpass;
+        for(; i < count; ++i)
+        {
+            lowpass = step(lowpass, src[i], alpha);
+            dst[i] = lowpass;
+        }
+        m_lowpass = lowpass;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void LowPass<data_t, uint_t, coeff_t>::reset(coeff_t alpha, uint_t first_value_offset)
     {
         m_lowpass = data_t();
         m_alpha = alpha;
         m_first_value_offset = ++first_value_offset;
     }
 
-    template <class data_t, class uint_t>
-    void LowPass<data_t, uint_t>::reset()
+    template <class data_t, class uint_t, class coeff_t>
+    void LowPass<data_t, uint_t, coeff_t>::reset()
     {
         m_lowpass = data_t();
     }
+
+    template <class data_t, class uint_t, class coeff_t>
+    data_t LowPass<data_t, uint_t, coeff_t>::step(const data_t& lowpass, const data_t& value, const coeff_t& alpha)
+    {
+        if constexpr(std::is_floating_point_v<coeff_t>)
+        {
+            return lowpass + alpha * (value - lowpass); //Refactored from [alpha * value + (1.0F - alpha) * lowpass]
+        }
+        else
+        {
+            // The difference of two values needs one bit more than data_t
+            using Fixed = FixedPoint<coeff_t>;
+            using product_t = typename Fixed::template product_t<sizeof(data_t) * 8 + 1>;
+
+            return Fixed::template saturate<data_t>(product_t(lowpass) + Fixed::multiply(product_t(value) - product_t(lowpass), alpha));
+        }
+    }
 }
 
 #endif // LOWPASS_H
@@ -0,0 +1,353 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Mirrored memory for circular buffers with very large windows. Linux only.
+ * The same physical pages are mapped twice, one copy right after the other, so
+ * an element at index i is also visible at index i + size. A window that wraps
+ * around the end of the memory continues in the mirror, so it is always one
+ * contiguous span that can be passed directly to std algorithms, SIMD code or
+ * file writes.
+ *
+ * MirrorMemory owns the mapping and can be passed to any buffer or filter.
+ * MirrorBuffer is a Buffer on top of a MirrorMemory, which adds window().
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Create an anonymous file with memfd_create() and set its size
+ * 2. Reserve address space for two copies of the memory
+ * 3. Map the file over both halves of the reserved space
+ *
+ * PROS
+ * ----
+ * 1. No wrap around handling. The whole window is one pointer and a count
+ * 2. No copying
+ *
+ * CONS
+ * ----
+ * 1. Linux only
+ * 2. The memory size in bytes must be a multiple of the page size, so it is
+ *    meant for large windows
+ * 3. The memory is allocated by the object, unlike all other buffers
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data the buffer will work with. Must be trivially copyable
+ * uint_t - Type of unsigned integers used troughout the class. The default
+ *          is 32-bit unsigned int, because the windows are large.
+ */
+
+#ifndef MIRRORBUFFER_H
+#define MIRRORBUFFER_H
+
+#if defined(__linux__)
+
+#include <type_traits>
+#include <stdexcept>
+#include <cstddef>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "buffer.h"
+
+namespace buffer
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t> class MirrorMemory
+    {
+        public:
+            /**
+             * @brief MirrorMemory Map mirrored memory
+             * @param size The number of elements. size * sizeof(data_t) must be a
+             *             multiple of the page size
+             */
+            explicit MirrorMemory(std::size_t size);
+            ~MirrorMemory();
+
+            MirrorMemory(const MirrorMemory&) = delete;
+            MirrorMemory& operator=(const MirrorMemory&) = delete;
+
+            // First copy of the memory. The mirror starts at data() + size()
+            inline data_t* data();
+            inline std::size_t size();
+            inline bool valid();
+
+        private:
+            inline void fail(const char* message);
+
+        private:
+            data_t* m_memory;
+            std::size_t m_size;
+    };
+
+    template <class data_t, class uint_t = unsigned int, bool full_capacity = false>
+    class MirrorBuffer: private MirrorMemory<data_t>, private Buffer<data_t, uint_t, 0, full_capacity>
+    {
+            using Memory = MirrorMemory<data_t>;
+            using Buffer = buffer::Buffer<data_t, uint_t, 0, full_capacity>;
+
+        public:
+            using Segment = typename Buffer::Segment;
+            using Segments = typename Buffer::Segments;
+            using iterator = typename Buffer::iterator;
+            using const_iterator = typename Buffer::const_iterator;
+            using reverse_iterator = typename Buffer::reverse_iterator;
+            using const_reverse_iterator = typename Buffer::const_reverse_iterator;
+
+        public:
+            /**
+             * @brief MirrorBuffer Construct a circular buffer with mirrored memory
+             * @param size The number of elements in the buffer. Must be a power of two and
+             *             size * sizeof(data_t) must be a multiple of the page size
+             */
+            explicit MirrorBuffer(uint_t size);
+
+            // All values in the buffer, from the oldest to the newest, as one contiguous segment
+            inline Segment window();
+
+            // The memory belongs to the object, so init() is not exported and the
+            // modifiers return the MirrorBuffer rather than the underlying Buffer
+            inline MirrorBuffer& pushFront(const data_t& value);
+            inline MirrorBuffer& pushFront(const data_t* src, uint_t count);
+            inline MirrorBuffer& pushBack(const data_t& value);
+            inline MirrorBuffer& popFront(data_t* value = nullptr);
+            inline MirrorBuffer& popBack(data_t* value = nullptr);
+            inline MirrorBuffer& popBack(data_t* dst, uint_t count);
+            inline MirrorBuffer& clear();
+            inline MirrorBuffer& rotateForeward();
+            inline MirrorBuffer& rotateBackward();
+            inline MirrorBuffer& operator<<(const data_t& value);
+            inline MirrorBuffer& operator>>(data_t& value);
+
+            using Buffer::full;
+            using Buffer::empty;
+            using Buffer::valid;
+            using Buffer::size;
+            using Buffer::count;
+            using Buffer::first;
+            using Buffer::last;
+            using Buffer::erase;
+            using Buffer::at;
+            using Buffer::segments;
+            using Buffer::copyToArray;
+            using Buffer::operator[];
+            using Buffer::begin;
+            using Buffer::end;
+            using Buffer::cbegin;
+            using Buffer::cend;
+            using Buffer::rbegin;
+            using Buffer::rend;
+            using Buffer::crbegin;
+            using Buffer::crend;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t>
+    MirrorMemory<data_t>::MirrorMemory(std::size_t size):
+        m_memory(nullptr),
+        m_size(0)
+    {
+        static_assert (std::is_trivially_copyable_v<data_t>, "Template type \"data_t\" expected to be trivially copyable");
+
+        const std::size_t bytes = size * sizeof(data_t);
+        const long page_size = sysconf(_SC_PAGESIZE);
+
+        if(size == 0 || page_size <= 0 || bytes % std::size_t(page_size))
+        {
+            fail("Size of the memory must be a multiple of the page size");
+            return;
+        }
+
+        const int fd = memfd_create("libfilter-ng", MFD_CLOEXEC);
+        if(fd < 0)
+        {
+            fail("Can not create the memory file");
+            return;
+        }
+
+        if(ftruncate(fd, off_t(bytes)) != 0)
+        {
+            close(fd);
+            fail("Can not set the size of the memory file");
+            return;
+        }
+
+        // Reserve address space for both copies, then map the file over each half
+        char* reserved = static_cast<char*>(mmap(nullptr, 2 * bytes, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0));
+        if(reserved == MAP_FAILED)
+        {
+            close(fd);
+            fail("Can not reserve address space for the memory");
+            return;
+        }
+
+        const bool mapped = mmap(reserved, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED &&
+                            mmap(reserved + bytes, bytes, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_FIXED, fd, 0) != MAP_FAILED;
+
+        // The mappings keep the file alive
+        close(fd);
+
+        if(!mapped)
+        {
+            munmap(reserved, 2 * bytes);
+            fail("Can not map the memory");
+            return;
+        }
+
+        m_memory = reinterpret_cast<data_t*>(reserved);
+        m_size = size;
+    }
+
+    template<class data_t>
+    MirrorMemory<data_t>::~MirrorMemory()
+    {
+        if(m_memory)
+            munmap(m_memory, 2 * m_size * sizeof(data_t));
+    }
+
+    template<class data_t>
+    data_t* MirrorMemory<data_t>::data()
+    {
+        return m_memory;
+    }
+
+    template<class data_t>
+    std::size_t MirrorMemory<data_t>::size()
+    {
+        return m_size;
+    }
+
+    template<class data_t>
+    bool MirrorMemory<data_t>::valid()
+    {
+        return m_memory != nullptr;
+    }
+
+    template<class data_t>
+    void MirrorMemory<data_t>::fail(const char* message)
+    {
+        if constexpr(use_exceptions)
+            throw std::runtime_error(message);
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>::MirrorBuffer(uint_t size):
+        Memory(size),
+        Buffer(Memory::data(), Memory::valid() ? size : 0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    typename MirrorBuffer<data_t, uint_t, full_capacity>::Segment MirrorBuffer<data_t, uint_t, full_capacity>::window()
+    {
+        // The values that wrap around the end of the memory continue in the mirror
+        return {Buffer::segments().back.data, Buffer::count()};
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::pushFront(const data_t& value)
+    {
+        Buffer::pushFront(value);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::pushFront(const data_t* src, uint_t count)
+    {
+        Buffer::pushFront(src, count);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::pushBack(const data_t& value)
+    {
+        Buffer::pushBack(value);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::popFront(data_t* value)
+    {
+        Buffer::popFront(value);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::popBack(data_t* value)
+    {
+        Buffer::popBack(value);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::popBack(data_t* dst, uint_t count)
+    {
+        Buffer::popBack(dst, count);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::clear()
+    {
+        Buffer::clear();
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::rotateForeward()
+    {
+        Buffer::rotateForeward();
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::rotateBackward()
+    {
+        Buffer::rotateBackward();
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::operator<<(const data_t& value)
+    {
+        Buffer::pushFront(value);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool full_capacity>
+    MirrorBuffer<data_t, uint_t, full_capacity>& MirrorBuffer<data_t, uint_t, full_capacity>::operator>>(data_t& value)
+    {
+        Buffer::popBack(&value);
+        return *this;
+    }
+}
+
+#endif // __linux__
+
+#endif // MIRRORBUFFER_H
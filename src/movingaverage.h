@@ -43,6 +43,13 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * N      - Size of the embedded buffer. If 0, the buffer is passed to the constructor
+ * full_capacity - If set, the window holds as many values as the buffer, a power of two.
+ *                 For integer types the average of a full window is then a shift,
+ *                 not a division
+ * sum_t  - Type of the running sum. For integer data_t choose a wider type, e.g. int32_t
+ *          for int16_t values, so the sum of the window can not overflow. The sum is
+ *          only increased and decreased, so it stays exact in integer arithmetic
  */
 
 #ifndef MOVINGAVERAGE_H
@@ -57,12 +64,13 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
-    class MovingAverage: protected buffer::Buffer<data_t, uint_t>
+    template <class data_t, class uint_t = unsigned short int, unsigned int N = 0, bool full_capacity = false, class sum_t = data_t>
+    class MovingAverage: protected buffer::Buffer<data_t, uint_t, N, full_capacity>
     {
-            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using Buffer = buffer::Buffer<data_t, uint_t, N, full_capacity>;
 
         public:
+            MovingAverage();
             MovingAverage(data_t *buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
@@ -72,29 +80,67 @@ namespace filter
             using Buffer::valid;
 
         private:
-            data_t m_sum;
+            inline void updateShift();
+            inline sum_t divideByShift(const sum_t& value);
+
+        private:
+            sum_t m_sum;
+            unsigned char m_shift;
     };
 
+    // MovingAverage with embedded buffer of N elements
+    template <class data_t, unsigned int N, class uint_t = unsigned short int, bool full_capacity = false, class sum_t = data_t>
+    using StaticMovingAverage = MovingAverage<data_t, uint_t, N, full_capacity, sum_t>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    MovingAverage<data_t, uint_t>::MovingAverage(data_t *buffer, uint_t buffer_size):
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::MovingAverage():
+        Buffer(),
+        m_sum(sum_t()),
+        m_shift(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
+        static_assert (N != 0, "Template parameter \"N\" expected to be the size of the embedded buffer");
+
+        updateShift();
+    }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::MovingAverage(data_t *buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size),
-        m_sum(data_t())
+        m_sum(sum_t()),
+        m_shift(0)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
+
+        updateShift();
     }
 
-    template<class data_t, class uint_t>
-    data_t MovingAverage<data_t, uint_t>::out()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    data_t MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::out()
     {
-        return m_sum/Buffer::count();
+        // The full window holds a power of two values
+        if constexpr(full_capacity && std::is_integral_v<sum_t>)
+        {
+            if(Buffer::full()) return data_t(divideByShift(m_sum));
+        }
+
+        // The count is not converted to sum_t, where it could wrap, and a signed sum is not converted to unsigned
+        if constexpr(std::is_integral_v<sum_t> && std::is_signed_v<sum_t> && sizeof(uint_t) >= sizeof(int))
+            return data_t(m_sum / static_cast<long long>(Buffer::count()));
+        else if constexpr(std::is_integral_v<sum_t>)
+            return data_t(m_sum / Buffer::count());
+        else
+            return data_t(m_sum / sum_t(Buffer::count()));
     }
 
-    template<class data_t, class uint_t>
-    void MovingAverage<data_t, uint_t>::in(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::in(const data_t& value)
     {
         if(!Buffer::valid()) return;
 
@@ -104,19 +150,42 @@ namespace filter
         Buffer::pushFront(value);
     }
 
-    template<class data_t, class uint_t>
-    void MovingAverage<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size)
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::reset(data_t *buffer, uint_t buffer_size)
     {
-        m_sum = data_t();
+        m_sum = sum_t();
         Buffer::init(buffer, buffer_size);
+        updateShift();
     }
 
-    template<class data_t, class uint_t>
-    void MovingAverage<data_t, uint_t>::reset()
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::reset()
     {
-        m_sum = data_t();
+        m_sum = sum_t();
         Buffer::clear();
     }
+
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::updateShift()
+    {
+        m_shift = 0;
+        while((1UL << m_shift) < Buffer::size()) ++m_shift;
+    }
+
+    // Same result as dividing by 2^m_shift, including the rounding toward zero of negative values
+    template<class data_t, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    sum_t MovingAverage<data_t, uint_t, N, full_capacity, sum_t>::divideByShift(const sum_t& value)
+    {
+        if constexpr(std::is_signed_v<sum_t>)
+        {
+            const sum_t bias = (value >> (sizeof(sum_t) * 8 - 1)) & ((sum_t(1) << m_shift) - 1);
+            return (value + bias) >> m_shift;
+        }
+        else
+        {
+            return value >> m_shift;
+        }
+    }
 }
 
 #endif // MOVINGAVERAGE_H
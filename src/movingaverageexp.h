@@ -55,12 +55,16 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * coeff_t - Type of the coefficient. float, or q15_t/q31_t for fixed point
+ *           arithmetic with integer data_t. See fixedpoint.h
  */
 
 #ifndef MOVINGAVERAGEEXP_H
 #define MOVINGAVERAGEEXP_H
 
 #include <type_traits>
+#include <cstddef>
+#include "fixedpoint.h"
 
 namespace filter
 {
@@ -68,45 +72,68 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
+    template <class data_t, class uint_t = unsigned short int, class coeff_t = float>
     class ExpMovingAverage
     {
         public:
             ExpMovingAverage(uint_t periods, uint_t first_value_offset = 0);
             data_t out();
             void in(const data_t& value);
+            /**
+             * @brief process Filter a block of values. Same result as calling in() and out()
+             *                for every value
+             * @param src Pointer to the values
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param count Number of values
+             */
+            void process(const data_t *src, data_t *dst, uint_t count);
             void reset(uint_t periods, uint_t first_value_offset = 0);
             void reset();
 
+        private:
+            // Filtering on several threads, see parallelscan.h
+            template <class d_t, class u_t, class c_t>
+            friend void processParallel(ExpMovingAverage<d_t, u_t, c_t> &filter, const d_t *src, d_t *dst, std::size_t count, unsigned int threads);
+
+            static inline coeff_t coefficient(uint_t periods);
+            static inline data_t step(const data_t& ema, const data_t& value, const coeff_t& alpha);
+
         private:
             data_t m_ema;
-            float  m_alpha;
+            coeff_t m_alpha;
             uint_t m_first_value_offset;
     };
 
+    // ExpMovingAverage with fixed point coefficient
+    template <class data_t, class uint_t = unsigned short int>
+    using ExpMovingAverageQ15 = ExpMovingAverage<data_t, uint_t, q15_t>;
+    template <class data_t, class uint_t = unsigned short int>
+    using ExpMovingAverageQ31 = ExpMovingAverage<data_t, uint_t, q31_t>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    ExpMovingAverage<data_t, uint_t>::ExpMovingAverage(uint_t periods, uint_t first_value_offset):
+    template<class data_t, class uint_t, class coeff_t>
+    ExpMovingAverage<data_t, uint_t, coeff_t>::ExpMovingAverage(uint_t periods, uint_t first_value_offset):
         m_ema(data_t()),
-        m_alpha(2.0F / (periods + 1)),
+        m_alpha(coefficient(periods)),
         m_first_value_offset(++first_value_offset)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_floating_point_v<coeff_t> || (std::is_integral_v<data_t> && sizeof(data_t) <= 4), "Template type \"data_t\" expected to be an integer of up to 32 bits for fixed point coefficient");
     }
 
-    template<class data_t, class uint_t>
-    data_t ExpMovingAverage<data_t, uint_t>::out()
+    template<class data_t, class uint_t, class coeff_t>
+    data_t ExpMovingAverage<data_t, uint_t, coeff_t>::out()
     {
         return m_ema;
     }
 
-    template<class data_t, class uint_t>
-    void ExpMovingAverage<data_t, uint_t>::in(const data_t& value)
+    template<class data_t, class uint_t, class coeff_t>
+    void ExpMovingAverage<data_t, uint_t, coeff_t>::in(const data_t& value)
     {
-        if(m_first_value_offset == 0) m_ema = m_alpha * (value - m_ema) + m_ema;
+        if(m_first_value_offset == 0) m_ema = step(m_ema, value, m_alpha);
         else
         {
             --m_first_value_offset;
@@ -114,19 +141,69 @@ namespace filter
         }
     }
 
-    template<class data_t, class uint_t>
-    void ExpMovingAverage<data_t, uint_t>::reset(uint_t periods, uint_t first_value_offset)
+    template<class data_t, class uint_t, class coeff_t>
+    void ExpMovingAverage<data_t, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t count)
+    {
+        uint_t i = 0;
+
+        // The first values are passed through
+        for(; i < count && m_first_value_offset != 0; ++i)
+        {
+            --m_first_value_offset;
+            m_ema = src[i];
+            dst[i] = m_ema;
+        }
+
+        // Keep the state in local variables, so it is not reloaded after every store to dst
+        const coeff_t alpha = m_alpha;
+        data_t ema = m_ema;
+        for(; i < count; ++i)
+        {
+            ema = step(ema, src[i], alpha);
+            dst[i] = ema;
+        }
+        m_ema = ema;
+    }
+
+    template<class data_t, class uint_t, class coeff_t>
+    void ExpMovingAverage<data_t, uint_t, coeff_t>::reset(uint_t periods, uint_t first_value_offset)
     {
         m_ema = data_t();
-        m_alpha = 2.0F / (periods + 1);
+        m_alpha = coefficient(periods);
         m_first_value_offset = ++first_value_offset;
     }
 
-    template<class data_t, class uint_t>
-    void ExpMovingAverage<data_t, uint_t>::reset()
+    template<class data_t, class uint_t, class coeff_t>
+    void ExpMovingAverage<data_t, uint_t, coeff_t>::reset()
     {
         m_ema = data_t();
     }
+
+    template<class data_t, class uint_t, class coeff_t>
+    coeff_t ExpMovingAverage<data_t, uint_t, coeff_t>::coefficient(uint_t periods)
+    {
+        if constexpr(std::is_floating_point_v<coeff_t>)
+            return 2.0F / (periods + 1);
+        else
+            return FixedPoint<coeff_t>::fromRatio(2, std::uint64_t(periods) + 1);
+    }
+
+    template<class data_t, class uint_t, class coeff_t>
+    data_t ExpMovingAverage<data_t, uint_t, coeff_t>::step(const data_t& ema, const data_t& value, const coeff_t& alpha)
+    {
+        if constexpr(std::is_floating_point_v<coeff_t>)
+        {
+            return alpha * (value - ema) + ema;
+        }
+        else
+        {
+            // The difference of two values needs one bit more than data_t
+            using Fixed = FixedPoint<coeff_t>;
+            using product_t = typename Fixed::template product_t<sizeof(data_t) * 8 + 1>;
+
+            return Fixed::template saturate<data_t>(Fixed::multiply(product_t(value) - product_t(ema), alpha) + product_t(ema));
+        }
+    }
 }
 
 #endif // MOVINGAVERAGEEXP_H
@@ -35,12 +35,26 @@
  *
  * ALGORITHM
  * ---------
+ * 1. Change = |value - value 'er_periods' ago|
+ * 2. Volatility = sum of |value - previous value| over the last 'er_periods' values.
+ *    It is kept as a running sum: on every in() the newest difference is added
+ *    and the one that leaves the window is subtracted. For floating point types it is
+ *    recalculated from the buffer once every buffer_size values, so the rounding
+ *    errors can not accumulate
+ * 3. Efficiency ratio ER = Change / Volatility, limited to [0, 1]
+ * 4. Smoothing constant SC = (ER * (fast α - slow α) + slow α)², where α = 2 / (periods + 1)
+ * 5. KAMA = KAMA(1) + SC * (value - KAMA(1)). Until there are enough values for the
+ *    efficiency ratio, KAMA follows the input
  *
  * PROS
  * ----
+ * 1. in() and out() are O(1), independent of 'er_periods'
+ * 2. The result does not depend on how often out() is called
  *
  * CONS
  * ----
+ * 1. The buffer must hold at least 'er_periods' + 1 values, i.e. buffer_size >= er_periods + 2.
+ *    Otherwise the filter is not valid
  *
  * TYPE
  * ----
@@ -83,12 +97,16 @@ namespace filter
 
         private:
             data_t abs(const data_t& value);
+            void validate();
+            void resync();
 
         private:
             uint_t m_er_periods;
-            uint_t m_slow_periods;
-            uint_t m_fast_periods;
+            float  m_slow_alpha;
+            float  m_fast_alpha;
+            data_t m_volatility;
             data_t m_kama;
+            uint_t m_resync_countdown;
     };
 
     /***********************************************************************/
@@ -99,55 +117,82 @@ namespace filter
     MovingAverageKaufman<data_t, uint_t>::MovingAverageKaufman(data_t *buffer, uint_t buffer_size, uint_t er_periods, uint_t slow_periods, uint_t fast_periods):
         Buffer(buffer, buffer_size),
         m_er_periods(er_periods),
-        m_slow_periods(slow_periods),
-        m_fast_periods(fast_periods),
-        m_kama(data_t())
+        m_slow_alpha(2.0F / (slow_periods + 1)),
+        m_fast_alpha(2.0F / (fast_periods + 1)),
+        m_volatility(data_t()),
+        m_kama(data_t()),
+        m_resync_countdown(buffer_size)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+
+        validate();
     }
 
     template<class data_t, class uint_t>
     data_t MovingAverageKaufman<data_t, uint_t>::out()
     {
-        // TODO: Not correct
-        if(!Buffer::full())
-            return data_t();
-
-        data_t change = abs(Buffer::first() - Buffer::at(m_er_periods));
-
-        // TODO: The for loop can be eliminated if this calculation is moved to the in() method
-        data_t volatility = data_t();
-        for(uint_t i = 0; i < m_er_periods; ++i) volatility += abs(Buffer::at(i) - Buffer::at(i+1));
-
-        data_t er = (volatility == 0)? 0 : (change / volatility);
-
-        data_t sc = er*( 2.0F/(m_fast_periods + 1) - 2.0F/(m_slow_periods + 1) ) + 2.0F/(m_slow_periods + 1);
-        sc *= sc;
-
-        m_kama = sc * (Buffer::first() - m_kama) + m_kama;
-
         return m_kama;
     }
 
     template<class data_t, class uint_t>
     void MovingAverageKaufman<data_t, uint_t>::in(const data_t& value)
     {
+        if(!Buffer::valid()) return;
+
+        const uint_t buffer_count = Buffer::count();
+
+        // Add the newest difference to the volatility and subtract the one that leaves the window
+        if(buffer_count > 0) m_volatility += abs(value - Buffer::first());
+        if(buffer_count > m_er_periods) m_volatility -= abs(Buffer::at(m_er_periods - 1) - Buffer::at(m_er_periods));
+
         Buffer::pushFront(value);
+
+        // Limit the accumulation of rounding errors
+        if constexpr(std::is_floating_point_v<data_t>)
+        {
+            if(--m_resync_countdown == 0) resync();
+        }
+
+        // Not enough values for the efficiency ratio yet, so KAMA follows the input
+        if(buffer_count < m_er_periods)
+        {
+            m_kama = value;
+            return;
+        }
+
+        const data_t change = abs(value - Buffer::at(m_er_periods));
+        float er = (m_volatility == 0)? 0.0F : (float(change) / float(m_volatility));
+
+        // The change can not be greater than the volatility, unless the sum lost precision
+        if(er > 1.0F) er = 1.0F;
+        else if(er < 0.0F) er = 0.0F;
+
+        float sc = er * (m_fast_alpha - m_slow_alpha) + m_slow_alpha;
+        sc *= sc;
+
+        m_kama = sc * (value - m_kama) + m_kama;
     }
 
     template<class data_t, class uint_t>
     void MovingAverageKaufman<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size, uint_t er_periods, uint_t slow_periods, uint_t fast_periods)
     {
         m_er_periods = er_periods;
-        m_slow_periods = slow_periods;
-        m_fast_periods = fast_periods;
+        m_slow_alpha = 2.0F / (slow_periods + 1);
+        m_fast_alpha = 2.0F / (fast_periods + 1);
+        m_volatility = data_t();
+        m_kama = data_t();
+        m_resync_countdown = buffer_size;
 
         Buffer::init(buffer, buffer_size);
+        validate();
     }
 
     template<class data_t, class uint_t>
     void MovingAverageKaufman<data_t, uint_t>::reset()
     {
+        m_volatility = data_t();
+        m_kama = data_t();
+        m_resync_countdown = Buffer::size() + 1;
         Buffer::clear();
     }
 
@@ -170,7 +215,33 @@ namespace filter
         return value;
     }
 
+    // The efficiency ratio needs the value 'er_periods' ago, so the buffer must hold er_periods + 1 values
+    template<class data_t, class uint_t>
+    void MovingAverageKaufman<data_t, uint_t>::validate()
+    {
+        if(m_er_periods != 0 && m_er_periods < Buffer::size())
+            return;
 
+        Buffer::init(nullptr, 0);
+
+        if constexpr(buffer::use_exceptions)
+        {
+            throw std::invalid_argument("Size of the buffer must be at least er_periods + 2");
+        }
+    }
+
+    // Recalculate the volatility from the values in the buffer
+    template<class data_t, class uint_t>
+    void MovingAverageKaufman<data_t, uint_t>::resync()
+    {
+        m_resync_countdown = Buffer::size() + 1;
+
+        const uint_t buffer_count = Buffer::count();
+        const uint_t differences = (buffer_count > m_er_periods) ? m_er_periods : buffer_count - 1;
+
+        m_volatility = data_t();
+        for(uint_t i = 0; i < differences; ++i) m_volatility += abs(Buffer::at(i) - Buffer::at(i + 1));
+    }
 }
 
 #endif // MOVINGAVERAGEKAUFMAN_H
@@ -28,9 +28,20 @@
  *
  * ALGORITHM
  * ---------
+ * The newest of n values has weight n, the oldest has weight 1.
+ * WMA = (n * x[0] + (n-1) * x[1] + ... + 1 * x[n-1]) / (n * (n+1) / 2)
+ *
+ * Both the plain sum S and the weighted sum Sw are kept up to date in in():
+ * 1. Buffer not full. The weights of the old values do not change and the new
+ *    value gets weight n+1: Sw' = Sw + (n+1) * x, S' = S + x
+ * 2. Buffer full. The weights of all old values drop by one and the oldest one
+ *    leaves the window: Sw' = Sw + n * x - S, S' = S + x - x_old
+ * 3. For floating point types both sums are recalculated from the buffer once
+ *    every buffer_size values, so the rounding errors can not accumulate
  *
  * PROS
  * ----
+ * 1. in() and out() are O(1), independent of the size of the buffer
  *
  * CONS
  * ----
@@ -46,12 +57,16 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * N      - Size of the embedded buffer. If 0, the buffer is passed to the constructor
+ * sum_t  - Type of the running sums. For integer data_t choose a wider type, e.g. int32_t
+ *          for uint8_t values, so the weighted sum of the window can not overflow
  */
 
 #ifndef MOVINGAVERAGEWEIGHTED_H
 #define MOVINGAVERAGEWEIGHTED_H
 
 #include <type_traits>
+#include <cstdint>
 #include "buffer.h"
 
 namespace filter
@@ -60,12 +75,13 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
-    class MovingWeightedAverage: protected buffer::Buffer<data_t, uint_t>
+    template <class data_t, class uint_t = unsigned short int, unsigned int N = 0, class sum_t = data_t>
+    class MovingWeightedAverage: protected buffer::Buffer<data_t, uint_t, N>
     {
-            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using Buffer = buffer::Buffer<data_t, uint_t, N>;
 
         public:
+            MovingWeightedAverage();
             MovingWeightedAverage(data_t *buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
@@ -75,58 +91,128 @@ namespace filter
             using Buffer::valid;
 
         private:
-            uint_t m_triangular_number;
+            void resync();
+
+        private:
+            sum_t m_sum;
+            sum_t m_weighted_sum;
+            // n * (n+1) / 2 overflows uint_t for large windows
+            std::uint64_t m_triangular_number;
+            uint_t m_resync_countdown;
     };
 
+    // MovingWeightedAverage with embedded buffer of N elements
+    template <class data_t, unsigned int N, class uint_t = unsigned short int, class sum_t = data_t>
+    using StaticMovingWeightedAverage = MovingWeightedAverage<data_t, uint_t, N, sum_t>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    MovingWeightedAverage<data_t, uint_t>::MovingWeightedAverage(data_t *buffer, uint_t buffer_size):
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    MovingWeightedAverage<data_t, uint_t, N, sum_t>::MovingWeightedAverage():
+        Buffer(),
+        m_sum(sum_t()),
+        m_weighted_sum(sum_t()),
+        m_triangular_number(0),
+        m_resync_countdown(N)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
+        static_assert (N != 0, "Template parameter \"N\" expected to be the size of the embedded buffer");
+    }
+
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    MovingWeightedAverage<data_t, uint_t, N, sum_t>::MovingWeightedAverage(data_t *buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size),
-        m_triangular_number(((buffer_size-1)*buffer_size)/2)
+        m_sum(sum_t()),
+        m_weighted_sum(sum_t()),
+        m_triangular_number(0),
+        m_resync_countdown(buffer_size)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
     }
 
-    template<class data_t, class uint_t>
-    data_t MovingWeightedAverage<data_t, uint_t>::out()
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    data_t MovingWeightedAverage<data_t, uint_t, N, sum_t>::out()
     {
-        data_t wma;
-        uint_t buffer_count = Buffer::count();
-        for(uint_t i = 0; i<buffer_count; ++i) wma += Buffer::at(i)*(float(buffer_count-i)/m_triangular_number);
+        if(m_triangular_number == 0)
+            return data_t();
 
-        return wma;
+        return data_t(m_weighted_sum / sum_t(m_triangular_number));
     }
 
-    template<class data_t, class uint_t>
-    void MovingWeightedAverage<data_t, uint_t>::in(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    void MovingWeightedAverage<data_t, uint_t, N, sum_t>::in(const data_t& value)
     {
         if(!Buffer::valid()) return;
 
         if(!Buffer::full())
         {
             Buffer::pushFront(value);
-            uint_t buffer_count = Buffer::count();
-            m_triangular_number = (buffer_count*(buffer_count+1))/2;
+            const std::uint64_t buffer_count = Buffer::count();
+            m_triangular_number = (buffer_count * (buffer_count + 1)) / 2;
+            m_weighted_sum += sum_t(buffer_count) * sum_t(value);
+            m_sum += value;
+        }
+        else
+        {
+            m_weighted_sum += sum_t(Buffer::count()) * sum_t(value) - m_sum;
+            m_sum += sum_t(value) - sum_t(Buffer::last());
+            Buffer::pushFront(value);
+        }
+
+        // Limit the accumulation of rounding errors
+        if constexpr(std::is_floating_point_v<sum_t>)
+        {
+            if(--m_resync_countdown == 0) resync();
         }
-        else Buffer::pushFront(value);
     }
 
-    template<class data_t, class uint_t>
-    void MovingWeightedAverage<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size)
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    void MovingWeightedAverage<data_t, uint_t, N, sum_t>::reset(data_t *buffer, uint_t buffer_size)
     {
-        if(!buffer) m_triangular_number = 0;
-        else m_triangular_number = ((buffer_size-1)*buffer_size)/2;
+        m_sum = sum_t();
+        m_weighted_sum = sum_t();
+        m_triangular_number = 0;
+        m_resync_countdown = buffer_size;
 
         Buffer::init(buffer, buffer_size);
     }
 
-    template<class data_t, class uint_t>
-    void MovingWeightedAverage<data_t, uint_t>::reset()
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    void MovingWeightedAverage<data_t, uint_t, N, sum_t>::reset()
     {
+        m_sum = sum_t();
+        m_weighted_sum = sum_t();
+        m_triangular_number = 0;
+        m_resync_countdown = Buffer::size() + 1;
+
         Buffer::clear();
     }
+
+    // Recalculate both sums from the values in the buffer
+    template<class data_t, class uint_t, unsigned int N, class sum_t>
+    void MovingWeightedAverage<data_t, uint_t, N, sum_t>::resync()
+    {
+        m_sum = sum_t();
+        m_weighted_sum = sum_t();
+        m_resync_countdown = Buffer::size() + 1;
+
+        // Traverse the buffer memory from the oldest to the newest value, which has the greatest weight
+        const typename Buffer::Segments segments = Buffer::segments();
+        uint_t weight = 0;
+        for(uint_t i = 0; i < segments.back.size; ++i)
+        {
+            m_sum += segments.back.data[i];
+            m_weighted_sum += sum_t(++weight) * sum_t(segments.back.data[i]);
+        }
+        for(uint_t i = 0; i < segments.front.size; ++i)
+        {
+            m_sum += segments.front.data[i];
+            m_weighted_sum += sum_t(++weight) * sum_t(segments.front.data[i]);
+        }
+    }
 }
 #endif // MOVINGAVERAGEWEIGHTED_H
@@ -57,6 +57,7 @@
  *          This type should be chosen carefully based on the CPU/MCU for
  *          optimal performance. A default type of 16-bit unsigned int is
  *          sufficient for most cases.
+ * N      - Size of the embedded buffer. If 0, the buffer is passed to the constructor
  */
 
 #ifndef MOVINGMEDIAN_H
@@ -71,12 +72,13 @@ namespace filter
     /***************************** Declaration *****************************/
     /***********************************************************************/
 
-    template <class data_t, class uint_t = unsigned short int>
-    class MovingMedian: protected buffer::Buffer<data_t, uint_t>
+    template <class data_t, class uint_t = unsigned short int, unsigned int N = 0>
+    class MovingMedian: protected buffer::Buffer<data_t, uint_t, N>
     {
-            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using Buffer = buffer::Buffer<data_t, uint_t, N>;
 
         public:
+            MovingMedian();
             MovingMedian(data_t *buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
@@ -86,84 +88,88 @@ namespace filter
             using Buffer::valid;
     };
 
+    // MovingMedian with embedded buffer of N elements
+    template <class data_t, unsigned int N, class uint_t = unsigned short int>
+    using StaticMovingMedian = MovingMedian<data_t, uint_t, N>;
+
     /***********************************************************************/
     /***************************** Definition ******************************/
     /***********************************************************************/
 
-    template<class data_t, class uint_t>
-    MovingMedian<data_t, uint_t>::MovingMedian(data_t *buffer, uint_t buffer_size):
+    template<class data_t, class uint_t, unsigned int N>
+    MovingMedian<data_t, uint_t, N>::MovingMedian():
+        Buffer()
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (N != 0, "Template parameter \"N\" expected to be the size of the embedded buffer");
+    }
+
+    template<class data_t, class uint_t, unsigned int N>
+    MovingMedian<data_t, uint_t, N>::MovingMedian(data_t *buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
     }
 
-    template<class data_t, class uint_t>
-    data_t MovingMedian<data_t, uint_t>::out()
+    template<class data_t, class uint_t, unsigned int N>
+    data_t MovingMedian<data_t, uint_t, N>::out()
     {
-        uint_t buffer_count = Buffer::count();
+        // The loops run directly over the buffer memory. The order of the elements does not matter
+        const typename Buffer::Segments segments = Buffer::segments();
+        const typename Buffer::Segment segment[2] = {segments.back, segments.front};
 
         // 1. Calculate the index of the median
-        uint_t middle_index = buffer_count/2;
-        data_t median_element;
-        data_t skip_greater_than;
-        data_t skip_lesser_than;
+        uint_t middle_index = Buffer::count()/2;
+        data_t skip_greater_than = data_t();
+        data_t skip_lesser_than = data_t();
         bool skip_greater_than_found = false;
         bool skip_lesser_than_found = false;
 
         // 2. Loop trough all the elements
-        for(uint_t i = 0; i < buffer_count; ++i)
+        for(const typename Buffer::Segment& outer: segment)
         {
-            data_t cur_element = Buffer::at(i);
-
-            // 5. To speed up the algirithm, if the element is on the right side of the median, skip all greater elements
-            if(skip_greater_than_found && cur_element >= skip_greater_than) continue;
-            // 5. To speed up the algirithm, if the element is on the left side of the median, skip all lesser elements
-            if(skip_lesser_than_found && cur_element <= skip_lesser_than) continue;
+            for(uint_t i = 0; i < outer.size; ++i)
+            {
+                const data_t cur_element = outer.data[i];
 
-            uint_t left_index= 0;
-            uint_t right_index = 0;
+                // 5. To speed up the algirithm, if the element is on the right side of the median, skip all greater elements
+                if(skip_greater_than_found && cur_element >= skip_greater_than) continue;
+                // 5. To speed up the algirithm, if the element is on the left side of the median, skip all lesser elements
+                if(skip_lesser_than_found && cur_element <= skip_lesser_than) continue;
 
-            /* 3. Count the smaller elements and those that are equal. That way we find the
-             *    first and the last index. Since the inner loop does not skip if the current element pass by itself,
-             *    it is counted twice and the right index can be calculated by subtracting 1
-             */
-            for(uint_t j = 0; j < buffer_count; ++j)
-            {
-                data_t cmp_element = Buffer::at(j);
+                uint_t left_index= 0;
+                uint_t right_index = 0;
 
-                if(cmp_element < cur_element)
+                /* 3. Count the smaller elements and those that are equal. That way we find the
+                 *    first and the last index. Since the inner loop does not skip if the current element pass by itself,
+                 *    it is counted twice and the right index can be calculated by subtracting 1
+                 */
+                for(const typename Buffer::Segment& inner: segment)
                 {
-                    ++left_index;
-                    ++right_index;
+                    for(uint_t j = 0; j < inner.size; ++j)
+                    {
+                        const data_t cmp_element = inner.data[j];
+
+                        /* We have to take into account that the inner loop does not skip an itteration
+                         * when it pass by itself, thus the right index is allways +1. When we test
+                         * at step (4.) we must take this into account and use the < sign and not <=
+                         */
+                        left_index += (cmp_element < cur_element);
+                        right_index += (cmp_element <= cur_element);
+                    }
                 }
-                /* We have to take into account that the inner loop does not skip an itteration
-                 * when it pass by itself, thus the right index is allways +1. When we test
-                 * at step (4.) we must take this into account and use the < sign and not <=
-                 */
-                else if(cmp_element == cur_element) ++right_index;
-            }
 
-            // 4. If this is the median break out of the loop and return it
-            if(left_index <= middle_index && middle_index < right_index)
-            {
-                median_element = cur_element;
-                break;
-            }
-            // 5. If the element is on the right side of the median, skip all others greater than it
-            else if(middle_index < left_index)
-            {
-                if(skip_greater_than_found) skip_greater_than = cur_element;
-                else
+                // 4. If this is the median return it
+                if(left_index <= middle_index && middle_index < right_index)
+                    return cur_element;
+                // 5. If the element is on the right side of the median, skip all others greater than it
+                else if(middle_index < left_index)
                 {
                     skip_greater_than_found = true;
                     skip_greater_than = cur_element;
                 }
-            }
-            // 5. If the element is on the left side of the median, skip all others lesser than it
-            else if(middle_index >= right_index)
-            {
-                if(skip_lesser_than_found) skip_lesser_than = cur_element;
-                else
+                // 5. If the element is on the left side of the median, skip all others lesser than it
+                else if(middle_index >= right_index)
                 {
                     skip_lesser_than_found = true;
                     skip_lesser_than = cur_element;
@@ -171,23 +177,23 @@ namespace filter
             }
         }
 
-        return median_element;
+        return data_t();
     }
 
-    template<class data_t, class uint_t>
-    void MovingMedian<data_t, uint_t>::in(const data_t& value)
+    template<class data_t, class uint_t, unsigned int N>
+    void MovingMedian<data_t, uint_t, N>::in(const data_t& value)
     {
         Buffer::pushFront(value);
     }
 
-    template<class data_t, class uint_t>
-    void MovingMedian<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size)
+    template<class data_t, class uint_t, unsigned int N>
+    void MovingMedian<data_t, uint_t, N>::reset(data_t *buffer, uint_t buffer_size)
     {
         Buffer::init(buffer, buffer_size);
     }
 
-    template<class data_t, class uint_t>
-    void MovingMedian<data_t, uint_t>::reset()
+    template<class data_t, class uint_t, unsigned int N>
+    void MovingMedian<data_t, uint_t, N>::reset()
     {
         Buffer::clear();
     }
@@ -0,0 +1,301 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Get the median value in the buffer. Same result as MovingMedian, but the
+ * sorted order of the window is maintained incrementally on every in(), so
+ * out() is a single array read.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. The elements of the window are kept in two binary heaps that share one array.
+ *    The median sits in the center of the array, the max-heap of the lesser elements
+ *    grows to the left and the min-heap of the greater elements grows to the right.
+ * 2. The heaps store the indexes of the circular buffer slots, not the values. A second
+ *    array maps every slot back to its position in the heap.
+ * 3. While the buffer is filling, the new element is placed at the next free position,
+ *    alternating between the two heaps, and is sifted up towards the median.
+ * 4. When the buffer is full, the new element takes the heap position of the element
+ *    that is popped out. It is sifted away from the median if it moved in that direction,
+ *    otherwise towards the median. If the median changed, the other heap is restored.
+ *
+ * PROS
+ * ----
+ * 1. The returned value is a real measurement value from the buffer
+ * 2. Remove outliers
+ * 3. in() is O(log N), out() is O(1)
+ *
+ * CONS
+ * ----
+ * 1. Require a second buffer for the heap indexes
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef MOVINGMEDIANHEAP_H
+#define MOVINGMEDIANHEAP_H
+
+#include <type_traits>
+#include "buffer.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class MovingMedianHeap: protected buffer::Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using int_t = std::make_signed_t<uint_t>;
+
+        public:
+            /**
+             * @brief MovingMedianHeap Construct a moving median filter with O(log N) update
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param index_buffer Pointer to the allocated memory for the heap indexes.
+             *                     Must hold 2 * buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingMedianHeap(data_t *buffer, uint_t *index_buffer, uint_t buffer_size);
+            data_t out();
+            void in(const data_t& value);
+            void reset(data_t *buffer, uint_t *index_buffer, uint_t buffer_size);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            inline void place(uint_t slot, int_t position);
+            inline bool less(int_t i, int_t j);
+            inline bool exchange(int_t i, int_t j);
+            inline int_t minCount();
+            inline int_t maxCount();
+            inline void minSortDown(int_t i);
+            inline void maxSortDown(int_t i);
+            inline bool minSortUp(int_t i);
+            inline bool maxSortUp(int_t i);
+
+        private:
+            uint_t *m_heap;
+            uint_t *m_position;
+            uint_t m_heap_center;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    MovingMedianHeap<data_t, uint_t>::MovingMedianHeap(data_t *buffer, uint_t *index_buffer, uint_t buffer_size):
+        Buffer(buffer, buffer_size),
+        m_heap(index_buffer),
+        m_position(index_buffer ? index_buffer + buffer_size : nullptr),
+        m_heap_center(buffer_size / 2 - 1)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingMedianHeap<data_t, uint_t>::out()
+    {
+        if(!m_heap || !Buffer::valid() || Buffer::empty())
+            return data_t();
+
+        return Buffer::getRawPtr()[m_heap[m_heap_center]];
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::in(const data_t& value)
+    {
+        if(!m_heap || !Buffer::valid())
+            return;
+
+        data_t *data = Buffer::getRawPtr();
+
+        // When the buffer is full the new element inherits the heap position of the poped one
+        if(Buffer::full())
+        {
+            const uint_t popped_slot = &Buffer::operator[](Buffer::count() - 1) - data;
+            const data_t popped = data[popped_slot];
+
+            Buffer::pushFront(value);
+
+            const int_t position = int_t(m_position[popped_slot]) - int_t(m_heap_center);
+            place(&Buffer::operator[](0) - data, position);
+
+            // New element is in the min-heap
+            if(position > 0)
+            {
+                if(popped < value) minSortDown(position * 2);
+                else if(minSortUp(position)) maxSortDown(-1);
+            }
+            // New element is in the max-heap
+            else if(position < 0)
+            {
+                if(value < popped) maxSortDown(position * 2);
+                else if(maxSortUp(position)) minSortDown(1);
+            }
+            // New element is the median
+            else
+            {
+                maxSortDown(-1);
+                minSortDown(1);
+            }
+        }
+        // Buffer is not full, thus the new element is appended alternately to the max-heap and the min-heap
+        else
+        {
+            const uint_t count = Buffer::count();
+
+            Buffer::pushFront(value);
+
+            const int_t position = int_t((count + 1) / 2) * ((count & 1) ? -1 : 1);
+            place(&Buffer::operator[](0) - data, position);
+
+            if(position > 0)
+            {
+                if(minSortUp(position)) maxSortDown(-1);
+            }
+            else if(position < 0)
+            {
+                if(maxSortUp(position)) minSortDown(1);
+            }
+        }
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::reset(data_t *buffer, uint_t *index_buffer, uint_t buffer_size)
+    {
+        m_heap = index_buffer;
+        m_position = index_buffer ? index_buffer + buffer_size : nullptr;
+        m_heap_center = buffer_size / 2 - 1;
+        Buffer::init(buffer, buffer_size);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::reset()
+    {
+        // The heap positions are reassigned while the buffer is filling, so there is nothing to clear
+        Buffer::clear();
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::place(uint_t slot, int_t position)
+    {
+        const uint_t index = m_heap_center + position;
+        m_heap[index] = slot;
+        m_position[slot] = index;
+    }
+
+    template<class data_t, class uint_t>
+    bool MovingMedianHeap<data_t, uint_t>::less(int_t i, int_t j)
+    {
+        const data_t *data = Buffer::getRawPtr();
+        return data[m_heap[m_heap_center + i]] < data[m_heap[m_heap_center + j]];
+    }
+
+    template<class data_t, class uint_t>
+    bool MovingMedianHeap<data_t, uint_t>::exchange(int_t i, int_t j)
+    {
+        const uint_t index_i = m_heap_center + i;
+        const uint_t index_j = m_heap_center + j;
+        const uint_t slot = m_heap[index_i];
+
+        m_heap[index_i] = m_heap[index_j];
+        m_heap[index_j] = slot;
+        m_position[m_heap[index_i]] = index_i;
+        m_position[m_heap[index_j]] = index_j;
+
+        return true;
+    }
+
+    // Number of elements in the min-heap, the median excluded
+    template<class data_t, class uint_t>
+    typename MovingMedianHeap<data_t, uint_t>::int_t MovingMedianHeap<data_t, uint_t>::minCount()
+    {
+        return int_t((Buffer::count() - 1) / 2);
+    }
+
+    // Number of elements in the max-heap, the median excluded
+    template<class data_t, class uint_t>
+    typename MovingMedianHeap<data_t, uint_t>::int_t MovingMedianHeap<data_t, uint_t>::maxCount()
+    {
+        return int_t(Buffer::count() / 2);
+    }
+
+    // Restore the min-heap property for all elements below i/2
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::minSortDown(int_t i)
+    {
+        const int_t count = minCount();
+        for(; i <= count; i *= 2)
+        {
+            // Pick the lesser child. The median has a single child, so position 1 has no sibling
+            if(i > 1 && i < count && less(i + 1, i)) ++i;
+            if(!(less(i, i / 2) && exchange(i, i / 2))) break;
+        }
+    }
+
+    // Restore the max-heap property for all elements below i/2
+    template<class data_t, class uint_t>
+    void MovingMedianHeap<data_t, uint_t>::maxSortDown(int_t i)
+    {
+        const int_t count = maxCount();
+        for(; i >= -count; i *= 2)
+        {
+            // Pick the greater child. The median has a single child, so position -1 has no sibling
+            if(i < -1 && i > -count && less(i, i - 1)) --i;
+            if(!(less(i / 2, i) && exchange(i / 2, i))) break;
+        }
+    }
+
+    // Restore the min-heap property for all elements above i. Return true if the median changed
+    template<class data_t, class uint_t>
+    bool MovingMedianHeap<data_t, uint_t>::minSortUp(int_t i)
+    {
+        while(i > 0 && less(i, i / 2) && exchange(i, i / 2)) i /= 2;
+        return i == 0;
+    }
+
+    // Restore the max-heap property for all elements above i. Return true if the median changed
+    template<class data_t, class uint_t>
+    bool MovingMedianHeap<data_t, uint_t>::maxSortUp(int_t i)
+    {
+        while(i < 0 && less(i / 2, i) && exchange(i / 2, i)) i /= 2;
+        return i == 0;
+    }
+}
+
+#endif // MOVINGMEDIANHEAP_H
@@ -0,0 +1,233 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Get the median value in the buffer for 8-bit and 16-bit integer values, such
+ * as raw ADC samples. Instead of comparing the values, the filter counts how many
+ * times every possible value is present in the buffer.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Keep a two level histogram of the values in the buffer. The fine level has one
+ *    counter for every possible value. The coarse level has one counter for every
+ *    group of fine counters, e.g. 256 groups of 256 values for 16-bit data
+ * 2. On every in() increment the counters of the new value and decrement the
+ *    counters of the poped out value
+ * 3. To get the median, walk the coarse counters accumulating them until the
+ *    median index is reached, then walk the fine counters of that group only
+ * 4. Signed values are shifted by flipping the sign bit, so the histogram is
+ *    ordered from the lowest to the highest value
+ *
+ * PROS
+ * ----
+ * 1. The returned value is a real measurement value from the buffer
+ * 2. Remove outliers
+ * 3. in() is O(1). out() does not depend on the size of the buffer,
+ *    so very large windows are cheap
+ *
+ * CONS
+ * ----
+ * 1. Only for integer types of up to 16 bits
+ * 2. Require a second buffer for the histogram: 272 counters for 8-bit
+ *    and 65792 counters for 16-bit values
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases. The histogram counters are of this type.
+ */
+
+#ifndef MOVINGMEDIANHISTOGRAM_H
+#define MOVINGMEDIANHISTOGRAM_H
+
+#include <type_traits>
+#include "buffer.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class MovingMedianHistogram: protected buffer::Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+            using udata_t = std::make_unsigned_t<data_t>;
+
+            static constexpr unsigned int value_bits = sizeof(data_t) * 8;
+            static constexpr unsigned int coarse_shift = value_bits / 2;
+            static constexpr unsigned long fine_size = 1UL << value_bits;
+            static constexpr unsigned long coarse_size = 1UL << (value_bits - coarse_shift);
+
+        public:
+            // Number of counters the histogram buffer must hold
+            static constexpr unsigned long histogram_size = fine_size + coarse_size;
+
+        public:
+            /**
+             * @brief MovingMedianHistogram Construct a histogram based moving median filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param histogram_buffer Pointer to the allocated memory for the histogram.
+             *                         Must hold histogram_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingMedianHistogram(data_t *buffer, uint_t *histogram_buffer, uint_t buffer_size);
+            data_t out();
+            void in(const data_t& value);
+            void reset(data_t *buffer, uint_t *histogram_buffer, uint_t buffer_size);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            static inline unsigned int toIndex(const data_t& value);
+            static inline data_t fromIndex(unsigned int index);
+            inline void clearHistogram();
+
+        private:
+            uint_t *m_histogram;
+            uint_t *m_coarse;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    MovingMedianHistogram<data_t, uint_t>::MovingMedianHistogram(data_t *buffer, uint_t *histogram_buffer, uint_t buffer_size):
+        Buffer(buffer, buffer_size),
+        m_histogram(histogram_buffer),
+        m_coarse(histogram_buffer ? histogram_buffer + fine_size : nullptr)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> && sizeof(data_t) <= 2, "Template type \"data_t\" expected to be 8-bit or 16-bit integer type");
+
+        clearHistogram();
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingMedianHistogram<data_t, uint_t>::out()
+    {
+        if(!m_histogram || !Buffer::valid() || Buffer::empty())
+            return data_t();
+
+        // Number of values lesser than the median
+        uint_t rank = Buffer::count() / 2;
+
+        // Find the group of values that holds the median
+        unsigned int index = 0;
+        while(m_coarse[index] <= rank) rank -= m_coarse[index++];
+
+        // Find the median inside the group
+        index <<= coarse_shift;
+        while(m_histogram[index] <= rank) rank -= m_histogram[index++];
+
+        return fromIndex(index);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHistogram<data_t, uint_t>::in(const data_t& value)
+    {
+        if(!m_histogram || !Buffer::valid())
+            return;
+
+        // When the buffer is full take into account the poped value
+        if(Buffer::full())
+        {
+            const unsigned int last = toIndex(Buffer::last());
+            --m_histogram[last];
+            --m_coarse[last >> coarse_shift];
+        }
+
+        Buffer::pushFront(value);
+
+        const unsigned int index = toIndex(value);
+        ++m_histogram[index];
+        ++m_coarse[index >> coarse_shift];
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHistogram<data_t, uint_t>::reset(data_t *buffer, uint_t *histogram_buffer, uint_t buffer_size)
+    {
+        m_histogram = histogram_buffer;
+        m_coarse = histogram_buffer ? histogram_buffer + fine_size : nullptr;
+        Buffer::init(buffer, buffer_size);
+        clearHistogram();
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHistogram<data_t, uint_t>::reset()
+    {
+        // Remove only the values that are still in the buffer. Cheaper than erasing the whole histogram
+        if(m_histogram)
+        {
+            const uint_t buffer_count = Buffer::count();
+            for(uint_t i = 0; i < buffer_count; ++i)
+            {
+                const unsigned int index = toIndex(Buffer::at(i));
+                --m_histogram[index];
+                --m_coarse[index >> coarse_shift];
+            }
+        }
+
+        Buffer::clear();
+    }
+
+    template<class data_t, class uint_t>
+    unsigned int MovingMedianHistogram<data_t, uint_t>::toIndex(const data_t& value)
+    {
+        // Flip the sign bit, so the negative values are ordered before the positive ones
+        if constexpr(std::is_signed_v<data_t>)
+            return udata_t(udata_t(value) ^ (udata_t(1) << (value_bits - 1)));
+        else
+            return value;
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingMedianHistogram<data_t, uint_t>::fromIndex(unsigned int index)
+    {
+        if constexpr(std::is_signed_v<data_t>)
+            return data_t(udata_t(index ^ (1U << (value_bits - 1))));
+        else
+            return data_t(index);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMedianHistogram<data_t, uint_t>::clearHistogram()
+    {
+        if(!m_histogram)
+            return;
+
+        for(unsigned long i = 0; i < histogram_size; ++i) m_histogram[i] = 0;
+    }
+}
+
+#endif // MOVINGMEDIANHISTOGRAM_H
@@ -0,0 +1,205 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Get the median value of a small window with a size known at compile time.
+ * Intended for spike removal, where windows of 3, 5, 7 or 9 values are used.
+ * The window is stored inside the object, no external buffer is required.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Copy the window to a local array
+ * 2. Run the optimal median selection network for the window size. Every step of the
+ *    network is a compare-exchange built from a min and a max, so there is no branching
+ *    and the compiler is free to use conditional moves or min/max instructions
+ * 3. The median is in the middle of the array
+ * 4. Until the window is filled, the values collected so far are sorted with insertion sort
+ *
+ * PROS
+ * ----
+ * 1. The returned value is a real measurement value from the buffer
+ * 2. Remove outliers
+ * 3. Very fast. Fixed number of operations and no branches once the window is full
+ *
+ * CONS
+ * ----
+ * 1. Only window sizes of 3, 5, 7 and 9 are supported
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * N      - Size of the window
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef MOVINGMEDIANN_H
+#define MOVINGMEDIANN_H
+
+#include <type_traits>
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, unsigned int N, class uint_t = unsigned short int>
+    class MovingMedianN
+    {
+        public:
+            MovingMedianN();
+            data_t out();
+            void in(const data_t& value);
+            void reset();
+            bool valid();
+
+            static inline data_t median(data_t *p);
+
+        private:
+            static inline void sort(data_t& a, data_t& b);
+
+        private:
+            data_t m_window[N];
+            uint_t m_index;
+            uint_t m_count;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, unsigned int N, class uint_t>
+    MovingMedianN<data_t, N, uint_t>::MovingMedianN():
+        m_window(),
+        m_index(0),
+        m_count(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (N == 3 || N == 5 || N == 7 || N == 9, "Template parameter \"N\" expected to be 3, 5, 7 or 9");
+    }
+
+    template<class data_t, unsigned int N, class uint_t>
+    data_t MovingMedianN<data_t, N, uint_t>::out()
+    {
+        data_t window[N];
+        for(uint_t i = 0; i < N; ++i) window[i] = m_window[i];
+
+        if(m_count == N)
+            return median(window);
+
+        if(m_count == 0)
+            return data_t();
+
+        // The window is not filled yet. Sort the collected values, there are less than N of them
+        for(uint_t i = 1; i < m_count; ++i)
+            for(uint_t j = i; j > 0 && window[j] < window[j - 1]; --j)
+                sort(window[j - 1], window[j]);
+
+        return window[m_count / 2];
+    }
+
+    template<class data_t, unsigned int N, class uint_t>
+    void MovingMedianN<data_t, N, uint_t>::in(const data_t& value)
+    {
+        m_window[m_index] = value;
+
+        // The order of the values in the window does not matter for the median, only the oldest one must be overwritten
+        if(++m_index == N) m_index = 0;
+        if(m_count < N) ++m_count;
+    }
+
+    template<class data_t, unsigned int N, class uint_t>
+    void MovingMedianN<data_t, N, uint_t>::reset()
+    {
+        m_index = 0;
+        m_count = 0;
+    }
+
+    template<class data_t, unsigned int N, class uint_t>
+    bool MovingMedianN<data_t, N, uint_t>::valid()
+    {
+        // The window is stored inside the object, so it is always valid
+        return true;
+    }
+
+    /**
+     * @brief median Get the median of N values using the optimal median selection network.
+     *        The values are partially sorted in place
+     * @param p Pointer to N values
+     */
+    template<class data_t, unsigned int N, class uint_t>
+    data_t MovingMedianN<data_t, N, uint_t>::median(data_t *p)
+    {
+        if constexpr(N == 3)
+        {
+            sort(p[0], p[1]); sort(p[1], p[2]); sort(p[0], p[1]);
+            return p[1];
+        }
+        else if constexpr(N == 5)
+        {
+            sort(p[0], p[1]); sort(p[3], p[4]); sort(p[0], p[3]);
+            sort(p[1], p[4]); sort(p[1], p[2]); sort(p[2], p[3]);
+            sort(p[1], p[2]);
+            return p[2];
+        }
+        else if constexpr(N == 7)
+        {
+            sort(p[0], p[5]); sort(p[0], p[3]); sort(p[1], p[6]);
+            sort(p[2], p[4]); sort(p[0], p[1]); sort(p[3], p[5]);
+            sort(p[2], p[6]); sort(p[2], p[3]); sort(p[3], p[6]);
+            sort(p[4], p[5]); sort(p[1], p[4]); sort(p[1], p[3]);
+            sort(p[3], p[4]);
+            return p[3];
+        }
+        else
+        {
+            sort(p[1], p[2]); sort(p[4], p[5]); sort(p[7], p[8]);
+            sort(p[0], p[1]); sort(p[3], p[4]); sort(p[6], p[7]);
+            sort(p[1], p[2]); sort(p[4], p[5]); sort(p[7], p[8]);
+            sort(p[0], p[3]); sort(p[5], p[8]); sort(p[4], p[7]);
+            sort(p[3], p[6]); sort(p[1], p[4]); sort(p[2], p[5]);
+            sort(p[4], p[7]); sort(p[4], p[2]); sort(p[6], p[4]);
+            sort(p[4], p[2]);
+            return p[4];
+        }
+    }
+
+    // Compare-exchange. After the call a holds the lesser and b the greater value
+    template<class data_t, unsigned int N, class uint_t>
+    void MovingMedianN<data_t, N, uint_t>::sort(data_t& a, data_t& b)
+    {
+        const data_t min = b < a ? b : a;
+        const data_t max = b < a ? a : b;
+        a = min;
+        b = max;
+    }
+}
+
+#endif // MOVINGMEDIANN_H
@@ -28,22 +28,27 @@
  *
  * ALGORITHM
  * ---------
- * 1. Find the minimum and maximum values in the buffer
- * 2. Calculate the aritmetic middle point between the min and max
- * 3. Set the middle element to be the first element. This is the initial condition
- * 4. Cycle trough all the elements and calculate the distance of every element to the middle
- * 5. If the distance of the current element is smaller than the last element,
- *    then set the element to be the current one
+ * 1. Keep a sorted copy of the values in the buffer. On every in() the poped value is
+ *    found with a binary search and removed, and the new value is inserted at the
+ *    position found with a binary search. The values between are moved by one in a
+ *    single contiguous copy. The buffer is never rescanned
+ * 2. The minimum and the maximum are the first and the last sorted values
+ * 3. Calculate the aritmetic middle point between the min and max
+ * 4. Find the first sorted value that is not less than the middle with a binary search.
+ *    The closest value to the middle is either this one or the one before it. If both
+ *    are equally distant, the lesser one is returned
  *
  * PROS
  * ----
  * 1. The returned value is a real measurement value from the buffer
  * 2. Dampens outliers
+ * 3. out() is O(log N)
  *
  * CONS
  * ----
- * 1. Slow
+ * 1. in() moves on average half of the sorted values, O(N) but as one memory copy
  * 2. Does not eliminate outliers as good as median filter
+ * 3. Require a second buffer for the sorted values
  *
  * TYPE
  * ----
@@ -76,17 +81,26 @@ namespace filter
             using Buffer = buffer::Buffer<data_t, uint_t>;
 
         public:
-            MovingMiddle(data_t *buffer, uint_t buffer_size);
+            /**
+             * @brief MovingMiddle Construct a moving middle filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param sorted_buffer Pointer to the allocated memory for the sorted values.
+             *                      Must hold buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingMiddle(data_t *buffer, data_t *sorted_buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
-            void reset(data_t *buffer, uint_t buffer_size);
+            void reset(data_t *buffer, data_t *sorted_buffer, uint_t buffer_size);
             void reset();
 
             using Buffer::valid;
 
         private:
-            data_t m_min;
-            data_t m_max;
+            inline uint_t lowerBound(const data_t& value, uint_t count);
+
+        private:
+            data_t *m_sorted;
     };
 
     /***********************************************************************/
@@ -94,10 +108,9 @@ namespace filter
     /***********************************************************************/
 
     template<class data_t, class uint_t>
-    MovingMiddle<data_t, uint_t>::MovingMiddle(data_t *buffer, uint_t buffer_size):
+    MovingMiddle<data_t, uint_t>::MovingMiddle(data_t *buffer, data_t *sorted_buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size),
-        m_min(data_t()),
-        m_max(data_t())
+        m_sorted(sorted_buffer)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
     }
@@ -105,104 +118,83 @@ namespace filter
     template<class data_t, class uint_t>
     data_t MovingMiddle<data_t, uint_t>::out()
     {
+        const uint_t count = Buffer::count();
+
         // There should be at least two elements to calculate the middle element
-        if(Buffer::count() < 2)
+        if(!m_sorted || count < 2)
             return data_t();
 
         // Calculate the aritmetic middle
-        const data_t middle = m_min + ((m_max - m_min) / 2.0F);
+        const data_t min = m_sorted[0];
+        const data_t middle = min + ((m_sorted[count - 1] - min) / 2.0F);
 
-        // Clear the prevoius middle value and set it to the first element
-        data_t element = Buffer::first();
+        // The closest value is the first one not less than the middle or the one before it
+        const uint_t upper = lowerBound(middle, count);
+        if(upper == count)
+            return m_sorted[count - 1];
+        if(upper == 0)
+            return m_sorted[0];
 
-        // Calculate the aritmetic distance of the element to the middle value
-        data_t element_to_middle_dist = (middle > element?middle-element:element-middle);
+        const data_t above = m_sorted[upper];
+        const data_t below = m_sorted[upper - 1];
 
-        // Find the value with the minimum distance to the middle value
-        for(uint_t i = 1; i<Buffer::count(); ++i)
-        {
-            data_t current = Buffer::at(i);
-            data_t cur_to_middle_dist = (middle > current?middle-current:current-middle);
-
-            // Save the element if the distance is closer than the previous one
-            if(cur_to_middle_dist<element_to_middle_dist)
-            {
-                element = current;
-                element_to_middle_dist = (middle > element?middle-element:element-middle);
-            }
-        }
-
-        return element;
+        return (above - middle < middle - below) ? above : below;
     }
 
     template<class data_t, class uint_t>
     void MovingMiddle<data_t, uint_t>::in(const data_t& value)
     {
-        if(!Buffer::valid())
+        if(!Buffer::valid() || !m_sorted)
             return;
 
-        // When the buffer is full take into account the poped value
+        uint_t count = Buffer::count();
+
+        // When the buffer is full, remove the poped value from the sorted values before the new one is inserted
         if(Buffer::full())
         {
-            const data_t last = Buffer::last();
-
-            Buffer::pushFront(value);
-
-            // Same value is inserted and poped out, so no action is required because the middle is not changed
-            if(value == last) return;
-            // Minimum value poped out and new value less than min
-            else if(last == m_min && value < m_min) m_min = value;
-            // Maximum value poped out and new value greater than max
-            else if(last == m_max && value > m_max) m_max = value;
-            // Maximum or minimum value poped out but new value between min and max
-            else if(last == m_min || last == m_max)
-            {
-                // Set initial value for the min and max
-                m_min = Buffer::first();
-                m_max = m_min;
-                uint_t buffer_count = Buffer::count();
-                for(uint_t i = 1; i < buffer_count; ++i)
-                {
-                    data_t current = Buffer::at(i);
-                    if(current < m_min) m_min = current;
-                    else if(current > m_max) m_max = current;
-                }
-            }
-            // Maximum value is not poped but a greater one is put in
-            else if(value > m_max) m_max = value;
-            // Minimum value is not poped but a lesser one is put in
-            else if(value < m_min) m_min = value;
-        }
-        // Buffer is not full, thus the min and max valuer are calculated using a simple compare operation
-        else
-        {
-            Buffer::pushFront(value);
-
-            // Set initial values for the min and max
-            if(Buffer::count() == 1)
-                m_min = m_max = value;
-            else if(value < m_min)
-                m_min = value;
-            else if(value > m_max)
-                m_max = value;
+            const uint_t position = lowerBound(Buffer::last(), count);
+            --count;
+            for(uint_t i = position; i < count; ++i) m_sorted[i] = m_sorted[i + 1];
         }
+
+        const uint_t position = lowerBound(value, count);
+        for(uint_t i = count; i > position; --i) m_sorted[i] = m_sorted[i - 1];
+        m_sorted[position] = value;
+
+        Buffer::pushFront(value);
     }
 
     template<class data_t, class uint_t>
-    void MovingMiddle<data_t, uint_t>::reset(data_t *buffer, uint_t buffer_size)
+    void MovingMiddle<data_t, uint_t>::reset(data_t *buffer, data_t *sorted_buffer, uint_t buffer_size)
     {
-        m_min = data_t();
-        m_max = data_t();
+        m_sorted = sorted_buffer;
         Buffer::init(buffer, buffer_size);
     }
 
     template<class data_t, class uint_t>
     void MovingMiddle<data_t, uint_t>::reset()
     {
-        m_min = data_t();
-        m_max = data_t();
         Buffer::clear();
     }
+
+    // Index of the first of the count sorted values that is not less than value, count if there is none
+    template<class data_t, class uint_t>
+    uint_t MovingMiddle<data_t, uint_t>::lowerBound(const data_t& value, uint_t count)
+    {
+        uint_t first = 0;
+        while(count > 0)
+        {
+            const uint_t half = count / 2;
+            if(m_sorted[first + half] < value)
+            {
+                first += half + 1;
+                count -= half + 1;
+            }
+            else count = half;
+        }
+
+        return first;
+    }
 }
 
 #endif // MOVINGMIDDLE_H
@@ -0,0 +1,143 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Get the minimum value in the buffer.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Keep a monotonic wedge of the values in the buffer. When a value is pushed, all
+ *    values it dominates are removed from the wedge, because they can never become the minimum
+ * 2. When the buffer is full, remove the poped value from the wedge if it is the minimum
+ * 3. The minimum is the oldest value in the wedge
+ *
+ * PROS
+ * ----
+ * 1. The returned value is a real measurement value from the buffer
+ * 2. in() is amortized O(1) and out() is O(1). The buffer is never rescanned
+ *
+ * CONS
+ * ----
+ * 1. Require a second buffer for the wedge
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef MOVINGMIN_H
+#define MOVINGMIN_H
+
+#include <type_traits>
+#include "buffer.h"
+#include "wedge.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class MovingMin: protected buffer::Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+
+        public:
+            /**
+             * @brief MovingMin Construct a moving minimum filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param wedge_buffer Pointer to the allocated memory for the wedge.
+             *                     Must hold buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingMin(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size);
+            data_t out();
+            void in(const data_t& value);
+            void reset(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            buffer::Wedge<data_t, uint_t, false> m_wedge;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    MovingMin<data_t, uint_t>::MovingMin(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size):
+        Buffer(buffer, buffer_size),
+        m_wedge(wedge_buffer, buffer_size)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingMin<data_t, uint_t>::out()
+    {
+        return m_wedge.extreme();
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMin<data_t, uint_t>::in(const data_t& value)
+    {
+        if(!Buffer::valid() || !m_wedge.valid())
+            return;
+
+        // When the buffer is full, remove the poped value from the wedge before the new one is pushed
+        if(Buffer::full())
+        {
+            m_wedge.pop(Buffer::last());
+        }
+
+        Buffer::pushFront(value);
+        m_wedge.push(value);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMin<data_t, uint_t>::reset(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size)
+    {
+        m_wedge.init(wedge_buffer, buffer_size);
+        Buffer::init(buffer, buffer_size);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMin<data_t, uint_t>::reset()
+    {
+        m_wedge.clear();
+        Buffer::clear();
+    }
+}
+
+#endif // MOVINGMIN_H
@@ -0,0 +1,261 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Track the number of values that fall in each bin of a fixed range, then select
+ * the most populated bin. The result is the center of that bin. Unlike the Moving
+ * Most Frequent Occurrence, values do not have to be exactly equal to be counted
+ * together, so the filter is usable for noisy floating point signals.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. The range [low, low + bins * width) is divided in bins of equal width.
+ *    The bin of a value is found directly: (value - low) * (1 / width).
+ *    Values outside the range are counted in the first or in the last bin
+ * 2. The bins with the same counter are linked in a list. There is one list
+ *    for every counter value, so the modal bin is the head of the list of the
+ *    greatest counter
+ * 3. When a value is pushed, its bin is moved to the list of the next counter.
+ *    When a value is poped out, its bin is moved to the list of the previous counter
+ * 4. If several bins share the greatest counter, the last one that reached it
+ *    is returned
+ *
+ * PROS
+ * ----
+ * 1. Good for steady signal
+ * 2. Removes outliers
+ * 3. in() and out() are O(1)
+ *
+ * CONS
+ * ----
+ * 1. The returned value is the center of a bin, not a real measurement value
+ * 2. Require two more buffers: one for the bins and one for the counter lists
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef MOVINGMOSTFREQUENTBIN_H
+#define MOVINGMOSTFREQUENTBIN_H
+
+#include <type_traits>
+#include "buffer.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class MovingMostFrequentBin: protected buffer::Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+
+        public:
+            struct Bin
+            {
+                    uint_t counter = 0;
+                    uint_t previous = 0;
+                    uint_t next = 0;
+            };
+
+        public:
+            /**
+             * @brief MovingMostFrequentBin Construct a binned most frequent occurrence filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param bin_buffer Pointer to the allocated memory for the bins. Must hold bins elements
+             * @param list_buffer Pointer to the allocated memory for the counter lists. Must hold buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             * @param low The lower end of the range
+             * @param width The width of a bin
+             * @param bins The number of bins
+             */
+            MovingMostFrequentBin(data_t* buffer, Bin* bin_buffer, uint_t* list_buffer, uint_t buffer_size, data_t low, float width, uint_t bins);
+            data_t out();
+            void in(const data_t& value);
+            void reset(data_t* buffer, Bin* bin_buffer, uint_t* list_buffer, uint_t buffer_size, data_t low, float width, uint_t bins);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            inline uint_t bin(const data_t& value);
+            inline void link(uint_t index);
+            inline void unlink(uint_t index);
+            inline void clearBins();
+
+        private:
+            Bin* m_bin_buffer;
+            uint_t* m_list;
+            data_t m_low;
+            float m_width;
+            float m_inverse_width;
+            uint_t m_bins;
+            uint_t m_list_size;
+            uint_t m_max_counter;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    MovingMostFrequentBin<data_t, uint_t>::MovingMostFrequentBin(data_t* buffer, Bin* bin_buffer, uint_t* list_buffer, uint_t buffer_size, data_t low, float width, uint_t bins):
+        Buffer(buffer, buffer_size),
+        m_bin_buffer(list_buffer && bins ? bin_buffer : nullptr),
+        m_list(bin_buffer && bins ? list_buffer : nullptr),
+        m_low(low),
+        m_width(width),
+        m_inverse_width(1.0F / width),
+        m_bins(bins),
+        m_list_size(buffer_size),
+        m_max_counter(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+
+        clearBins();
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingMostFrequentBin<data_t, uint_t>::out()
+    {
+        if(!m_bin_buffer || !Buffer::valid() || m_max_counter == 0)
+            return data_t();
+
+        // Return the center of the modal bin
+        return m_low + (m_list[m_max_counter] + 0.5F) * m_width;
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::in(const data_t& value)
+    {
+        if(!m_bin_buffer || !Buffer::valid())
+            return;
+
+        const uint_t pushed = bin(value);
+
+        // If the buffer is full, move the bin of the poped value to the list of the lesser counter
+        if(Buffer::full())
+        {
+            const uint_t poped = bin(Buffer::last());
+
+            // Same bin is inserted and poped out, so no action is required because the mode is not changed
+            if(poped == pushed)
+            {
+                Buffer::pushFront(value);
+                return;
+            }
+
+            const uint_t counter = m_bin_buffer[poped].counter;
+            unlink(poped);
+            if(m_list[counter] == m_bins && counter == m_max_counter) --m_max_counter;
+            if(--m_bin_buffer[poped].counter) link(poped);
+        }
+
+        Buffer::pushFront(value);
+
+        // Move the bin of the pushed value to the list of the greater counter
+        if(m_bin_buffer[pushed].counter) unlink(pushed);
+        if(++m_bin_buffer[pushed].counter > m_max_counter) m_max_counter = m_bin_buffer[pushed].counter;
+        link(pushed);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::reset(data_t* buffer, Bin* bin_buffer, uint_t* list_buffer, uint_t buffer_size, data_t low, float width, uint_t bins)
+    {
+        m_bin_buffer = list_buffer && bins ? bin_buffer : nullptr;
+        m_list = bin_buffer && bins ? list_buffer : nullptr;
+        m_low = low;
+        m_width = width;
+        m_inverse_width = 1.0F / width;
+        m_bins = bins;
+        m_list_size = buffer_size;
+        Buffer::init(buffer, buffer_size);
+        clearBins();
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::reset()
+    {
+        Buffer::clear();
+        clearBins();
+    }
+
+    // Get the index of the bin of the value. Values outside the range go to the first or the last bin
+    template<class data_t, class uint_t>
+    uint_t MovingMostFrequentBin<data_t, uint_t>::bin(const data_t& value)
+    {
+        const float position = (value - m_low) * m_inverse_width;
+
+        if(!(position >= 0.0F)) return 0;
+        if(position >= m_bins) return m_bins - 1;
+        return uint_t(position);
+    }
+
+    // Insert the bin at the head of the list for its counter
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::link(uint_t index)
+    {
+        Bin& bin = m_bin_buffer[index];
+        const uint_t head = m_list[bin.counter];
+
+        bin.previous = m_bins;
+        bin.next = head;
+        if(head != m_bins) m_bin_buffer[head].previous = index;
+        m_list[bin.counter] = index;
+    }
+
+    // Remove the bin from the list for its counter
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::unlink(uint_t index)
+    {
+        const Bin& bin = m_bin_buffer[index];
+
+        if(bin.previous != m_bins) m_bin_buffer[bin.previous].next = bin.next;
+        else m_list[bin.counter] = bin.next;
+        if(bin.next != m_bins) m_bin_buffer[bin.next].previous = bin.previous;
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMostFrequentBin<data_t, uint_t>::clearBins()
+    {
+        m_max_counter = 0;
+
+        if(!m_bin_buffer || !Buffer::valid())
+            return;
+
+        for(uint_t i = 0; i < m_bins; ++i) m_bin_buffer[i].counter = 0;
+        for(uint_t i = 0; i < m_list_size; ++i) m_list[i] = m_bins;
+    }
+}
+#endif // MOVINGMOSTFREQUENTBIN_H
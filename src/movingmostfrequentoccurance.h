@@ -28,16 +28,33 @@
  *
  * ALGORITHM
  * ---------
+ * 1. Every distinct value in the buffer has an occurrence record with its counter
+ * 2. An open addressing hash table with linear probing maps the values to their
+ *    records. It has twice as many slots as the buffer, so it is at most half full.
+ *    Removed entries are deleted by shifting the following entries back, so
+ *    there are no tombstones
+ * 3. The records with the same counter are linked in a list. There is one list
+ *    for every counter value, so the most frequent value is the head of the list
+ *    of the greatest counter
+ * 4. When a value is pushed, its record is moved from its list to the next one.
+ *    When a value is poped out, its record is moved to the previous list and is
+ *    released if the counter reaches 0
+ * 5. If several values share the greatest counter, the last one that reached it
+ *    is returned
  *
  * PROS
  * ----
 * 1. The returned value is a real measurement value from the buffer
 * 2. Good for steady signal
 * 3. Removes outliers
+* 4. in() and out() are O(1)
  *
  * CONS
  * ----
- * 1. Slow
+ * 1. Require two more buffers: one for the occurrence records and one for the
+ *    hash table and the counter lists
+ * 2. Values are compared for exact equality. Not of much use for noisy floating point signals
+ * 3. NaN values are ignored and are not pushed into the buffer
  *
  * TYPE
  * ----
@@ -56,6 +73,7 @@
 #define MOVINGMOSTFREQUENTOCCURRENCE_H
 
 #include <type_traits>
+#include <cstring>
 #include "buffer.h"
 
 namespace filter
@@ -74,19 +92,44 @@ namespace filter
             {
                     data_t value;
                     uint_t counter = 0;
+                    uint_t previous = 0;
+                    uint_t next = 0;
             };
 
         public:
-            MovingMostFrequentOccurrence(data_t* buffer, Occurrence* occurrence_buffer, uint_t buffer_size);
+            /**
+             * @brief MovingMostFrequentOccurrence Construct a most frequent occurrence filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param occurrence_buffer Pointer to the allocated memory for the occurrence records.
+             *                          Must hold buffer_size elements
+             * @param index_buffer Pointer to the allocated memory for the hash table and the counter lists.
+             *                     Must hold 3 * buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingMostFrequentOccurrence(data_t* buffer, Occurrence* occurrence_buffer, uint_t* index_buffer, uint_t buffer_size);
             data_t out();
             void in(const data_t& value);
-            void reset(data_t* buffer, Occurrence* occurrence_buffer, uint_t buffer_size);
+            void reset(data_t* buffer, Occurrence* occurrence_buffer, uint_t* index_buffer, uint_t buffer_size);
             void reset();
 
             using Buffer::valid;
 
+        private:
+            static inline unsigned long long hash(const data_t& value);
+            inline uint_t find(const data_t& value);
+            inline void remove(uint_t slot);
+            inline void link(uint_t occurrence);
+            inline void unlink(uint_t occurrence);
+            inline void clearIndex();
+
         private:
             Occurrence* m_occurrence_buffer;
+            uint_t* m_table;
+            uint_t* m_list;
+            uint_t m_table_mask;
+            uint_t m_nil;
+            uint_t m_free;
+            uint_t m_max_counter;
     };
 
     /***********************************************************************/
@@ -94,29 +137,29 @@ namespace filter
     /***********************************************************************/
 
     template<class data_t, class uint_t>
-    MovingMostFrequentOccurrence<data_t, uint_t>::MovingMostFrequentOccurrence(data_t* buffer, Occurrence* occurrence_buffer, uint_t buffer_size):
+    MovingMostFrequentOccurrence<data_t, uint_t>::MovingMostFrequentOccurrence(data_t* buffer, Occurrence* occurrence_buffer, uint_t* index_buffer, uint_t buffer_size):
         Buffer(buffer, buffer_size),
-        m_occurrence_buffer(occurrence_buffer)
+        m_occurrence_buffer(index_buffer ? occurrence_buffer : nullptr),
+        m_table(occurrence_buffer ? index_buffer : nullptr),
+        m_list(m_table ? m_table + 2 * buffer_size : nullptr),
+        m_table_mask(2 * buffer_size - 1),
+        m_nil(buffer_size),
+        m_free(0),
+        m_max_counter(0)
     {
         static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_arithmetic_v<data_t>, "Template type \"data_t\" expected to be of arithmetic type");
+
+        clearIndex();
     }
 
     template<class data_t, class uint_t>
     data_t MovingMostFrequentOccurrence<data_t, uint_t>::out()
     {
-        if(!m_occurrence_buffer || !Buffer::valid())
+        if(!m_occurrence_buffer || !Buffer::valid() || m_max_counter == 0)
             return data_t();
 
-        Occurrence mfo = m_occurrence_buffer[0];
-
-        uint_t buffer_size = Buffer::count();
-        for(uint_t i = 1; i < buffer_size; ++i)
-        {
-            if(m_occurrence_buffer[i].counter > mfo.counter)
-                mfo = m_occurrence_buffer[i];
-        }
-
-        return mfo.value;
+        return m_occurrence_buffer[m_list[m_max_counter]].value;
     }
 
     template<class data_t, class uint_t>
@@ -125,7 +168,10 @@ namespace filter
         if(!m_occurrence_buffer || !Buffer::valid())
             return;
 
-        uint_t buffer_size= Buffer::size();
+        // NaN is not equal to itself, so it can not be counted. Reject it, otherwise each one would take a record
+        if constexpr(std::is_floating_point_v<data_t>)
+            if(value != value)
+                return;
 
         // If the buffer is full, take into account the poped out value
         if(Buffer::full())
@@ -139,49 +185,164 @@ namespace filter
                 return;
             }
 
-            // Decrease the poped value counter and clear the value if the number of occurrences is 0
-            for(uint_t i = 0; i < buffer_size; ++i)
+            // Move the poped value to the list of the lesser counter and release it if the number of occurrences is 0
+            const uint_t slot = find(last);
+            if(m_table[slot] != m_nil)
             {
-                if(m_occurrence_buffer[i].value == last)
+                const uint_t index = m_table[slot];
+                const uint_t counter = m_occurrence_buffer[index].counter;
+
+                unlink(index);
+                if(m_list[counter] == m_nil && counter == m_max_counter) --m_max_counter;
+
+                if(--m_occurrence_buffer[index].counter == 0)
                 {
-                    --m_occurrence_buffer[i].counter;
-                    if(m_occurrence_buffer[i].counter == 0)
-                        m_occurrence_buffer[i].value = data_t();
-                    break;
+                    remove(slot);
+                    m_occurrence_buffer[index].value = data_t();
+                    m_occurrence_buffer[index].next = m_free;
+                    m_free = index;
                 }
+                else link(index);
             }
         }
 
         Buffer::pushFront(value);
 
-        uint_t index = 0;
-        // Find the index of the pushed value or select an empty index
-        for(uint_t i = 0; i < buffer_size; ++i)
+        // Find the record of the pushed value or take a free one
+        const uint_t slot = find(value);
+        uint_t index = m_table[slot];
+        if(index == m_nil)
         {
-            if(m_occurrence_buffer[i].value == value)
-            {
-                index = i;
-                break;
-            }
-            if(m_occurrence_buffer[i].counter == 0)
-                index = i;
+            // There is always a free record, because the buffer holds at most buffer_size distinct values
+            index = m_free;
+            m_free = m_occurrence_buffer[index].next;
+            m_occurrence_buffer[index].value = value;
+            m_table[slot] = index;
         }
+        else unlink(index);
 
-        m_occurrence_buffer[index].value = value;
-        ++m_occurrence_buffer[index].counter;
+        // Move the pushed value to the list of the greater counter
+        if(++m_occurrence_buffer[index].counter > m_max_counter) m_max_counter = m_occurrence_buffer[index].counter;
+        link(index);
     }
 
     template<class data_t, class uint_t>
-    void MovingMostFrequentOccurrence<data_t, uint_t>::reset(data_t* buffer, Occurrence* occurrence_buffer, uint_t buffer_size)
+    void MovingMostFrequentOccurrence<data_t, uint_t>::reset(data_t* buffer, Occurrence* occurrence_buffer, uint_t* index_buffer, uint_t buffer_size)
     {
-        m_occurrence_buffer = occurrence_buffer;
+        m_occurrence_buffer = index_buffer ? occurrence_buffer : nullptr;
+        m_table = occurrence_buffer ? index_buffer : nullptr;
+        m_list = m_table ? m_table + 2 * buffer_size : nullptr;
+        m_table_mask = 2 * buffer_size - 1;
+        m_nil = buffer_size;
         Buffer::init(buffer, buffer_size);
+        clearIndex();
     }
 
     template<class data_t, class uint_t>
     void MovingMostFrequentOccurrence<data_t, uint_t>::reset()
     {
         Buffer::clear();
+        clearIndex();
+    }
+
+    template<class data_t, class uint_t>
+    unsigned long long MovingMostFrequentOccurrence<data_t, uint_t>::hash(const data_t& value)
+    {
+        unsigned long long bits = 0;
+
+        if constexpr(std::is_floating_point_v<data_t>)
+        {
+            // Equal values must have equal hashes: -0.0 is folded to 0.0 and the padding of long double is dropped
+            const double normalized = (value == 0) ? 0.0 : double(value);
+            std::memcpy(&bits, &normalized, sizeof(normalized));
+        }
+        else bits = static_cast<unsigned long long>(value);
+
+        // Mix the bits, so that values differing only in the high bits land in different slots
+        bits ^= bits >> 32;
+        bits *= 0x9E3779B97F4A7C15ULL;
+        bits ^= bits >> 29;
+
+        return bits;
+    }
+
+    // Get the hash table slot of the value, or the empty slot where it should be inserted
+    template<class data_t, class uint_t>
+    uint_t MovingMostFrequentOccurrence<data_t, uint_t>::find(const data_t& value)
+    {
+        uint_t slot = hash(value) & m_table_mask;
+        while(m_table[slot] != m_nil && !(m_occurrence_buffer[m_table[slot]].value == value))
+            slot = (slot + 1) & m_table_mask;
+
+        return slot;
+    }
+
+    // Remove the entry from the hash table and shift back the following entries that were displaced by it
+    template<class data_t, class uint_t>
+    void MovingMostFrequentOccurrence<data_t, uint_t>::remove(uint_t slot)
+    {
+        uint_t next = slot;
+        while(true)
+        {
+            next = (next + 1) & m_table_mask;
+            if(m_table[next] == m_nil)
+                break;
+
+            // The entry stays if its home slot is cyclically between the empty slot and its current slot
+            const uint_t home = hash(m_occurrence_buffer[m_table[next]].value) & m_table_mask;
+            if(slot <= next ? (slot < home && home <= next) : (slot < home || home <= next))
+                continue;
+
+            m_table[slot] = m_table[next];
+            slot = next;
+        }
+
+        m_table[slot] = m_nil;
+    }
+
+    // Insert the occurrence at the head of the list for its counter
+    template<class data_t, class uint_t>
+    void MovingMostFrequentOccurrence<data_t, uint_t>::link(uint_t occurrence)
+    {
+        Occurrence& record = m_occurrence_buffer[occurrence];
+        const uint_t head = m_list[record.counter];
+
+        record.previous = m_nil;
+        record.next = head;
+        if(head != m_nil) m_occurrence_buffer[head].previous = occurrence;
+        m_list[record.counter] = occurrence;
+    }
+
+    // Remove the occurrence from the list for its counter
+    template<class data_t, class uint_t>
+    void MovingMostFrequentOccurrence<data_t, uint_t>::unlink(uint_t occurrence)
+    {
+        const Occurrence& record = m_occurrence_buffer[occurrence];
+
+        if(record.previous != m_nil) m_occurrence_buffer[record.previous].next = record.next;
+        else m_list[record.counter] = record.next;
+        if(record.next != m_nil) m_occurrence_buffer[record.next].previous = record.previous;
+    }
+
+    template<class data_t, class uint_t>
+    void MovingMostFrequentOccurrence<data_t, uint_t>::clearIndex()
+    {
+        m_free = 0;
+        m_max_counter = 0;
+
+        if(!m_occurrence_buffer || !Buffer::valid())
+            return;
+
+        // Chain all the records in the free list
+        for(uint_t i = 0; i < m_nil; ++i)
+        {
+            m_occurrence_buffer[i].value = data_t();
+            m_occurrence_buffer[i].counter = 0;
+            m_occurrence_buffer[i].next = i + 1;
+            m_list[i] = m_nil;
+        }
+
+        for(uint_t i = 0; i <= m_table_mask; ++i) m_table[i] = m_nil;
     }
 }
 #endif // MOVINGMOSTFREQUENTOCCURRENCE_H
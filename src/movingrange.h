@@ -0,0 +1,152 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Get the range of the values in the buffer. This is the difference between the
+ * maximum and the minimum value, also known as the peak-to-peak value.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Track the minimum and the maximum values in the buffer with two monotonic wedges.
+ *    When a value is pushed, all values it dominates are removed from the wedges,
+ *    because they can never become the minimum or the maximum
+ * 2. When the buffer is full, remove the poped value from the wedges if it is the
+ *    current minimum or maximum
+ * 3. The range is the difference of the oldest values in the two wedges
+ *
+ * PROS
+ * ----
+ * 1. in() is amortized O(1) and out() is O(1). The buffer is never rescanned
+ *
+ * CONS
+ * ----
+ * 1. Require a second buffer for the wedges
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data, the filter will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef MOVINGRANGE_H
+#define MOVINGRANGE_H
+
+#include <type_traits>
+#include "buffer.h"
+#include "wedge.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int>
+    class MovingRange: protected buffer::Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+
+        public:
+            /**
+             * @brief MovingRange Construct a moving range filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param wedge_buffer Pointer to the allocated memory for the wedges.
+             *                     Must hold 2 * buffer_size elements
+             * @param buffer_size The number of elements in the circular buffer
+             */
+            MovingRange(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size);
+            data_t out();
+            void in(const data_t& value);
+            void reset(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            buffer::Wedge<data_t, uint_t, false> m_min;
+            buffer::Wedge<data_t, uint_t, true> m_max;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    MovingRange<data_t, uint_t>::MovingRange(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size):
+        Buffer(buffer, buffer_size),
+        m_min(wedge_buffer, buffer_size),
+        m_max(wedge_buffer ? wedge_buffer + buffer_size : nullptr, buffer_size)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t>
+    data_t MovingRange<data_t, uint_t>::out()
+    {
+        return m_max.extreme() - m_min.extreme();
+    }
+
+    template<class data_t, class uint_t>
+    void MovingRange<data_t, uint_t>::in(const data_t& value)
+    {
+        if(!Buffer::valid() || !m_min.valid())
+            return;
+
+        // When the buffer is full, remove the poped value from the wedges before the new one is pushed
+        if(Buffer::full())
+        {
+            const data_t last = Buffer::last();
+            m_min.pop(last);
+            m_max.pop(last);
+        }
+
+        Buffer::pushFront(value);
+        m_min.push(value);
+        m_max.push(value);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingRange<data_t, uint_t>::reset(data_t *buffer, data_t *wedge_buffer, uint_t buffer_size)
+    {
+        m_min.init(wedge_buffer, buffer_size);
+        m_max.init(wedge_buffer ? wedge_buffer + buffer_size : nullptr, buffer_size);
+        Buffer::init(buffer, buffer_size);
+    }
+
+    template<class data_t, class uint_t>
+    void MovingRange<data_t, uint_t>::reset()
+    {
+        m_min.clear();
+        m_max.clear();
+        Buffer::clear();
+    }
+}
+
+#endif // MOVINGRANGE_H
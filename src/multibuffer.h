@@ -0,0 +1,273 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Circular buffer for several channels that are sampled together, for example the
+ * axes of an IMU. Every element of the buffer is a frame with one value per channel.
+ * MultiBuffer is a Buffer of frames, so all channels share the same head, tail and
+ * count, and pushing a frame updates the indexes once. Same as Buffer, the real size
+ * is the set value minus one, unless in full capacity mode.
+ *
+ * The memory is an array of Frame objects, each holding one value per channel, so
+ * the values are stored as frame 0 channel 0, frame 0 channel 1, ..., frame 1
+ * channel 0 and so on. An operation applied to all channels of a frame is a loop
+ * over contiguous memory, which the compiler can vectorize.
+ * Segments and iterators are the ones of Buffer and give access to whole frames.
+ *
+ * PROS
+ * ----
+ * 1. One index update per frame, regardless of the number of channels
+ * 2. Per frame operations are vectorizable
+ *
+ * CONS
+ * ----
+ * 1. The size of the buffer must be a power of 2
+ * 2. The values of one channel are not contiguous
+ *
+ * DATA TYPES
+ * ----------
+ * data_t   - Type of the data the buffer will work with
+ * channels - Number of values in a frame
+ * uint_t   - Type of unsigned integers used troughout the class.
+ *            This type should be chosen carefully based on the CPU/MCU for
+ *            optimal performance. A default type of 16-bit unsigned int is
+ *            sufficient for most cases.
+ * N        - Number of frames in the embedded memory. Must be a power of two. If 0,
+ *            the memory is passed to the constructor
+ * full_capacity - If set, all frames of the memory are used and the real size
+ *                 is a power of two
+ */
+
+#ifndef MULTIBUFFER_H
+#define MULTIBUFFER_H
+
+#include <type_traits>
+#include "buffer.h"
+
+namespace buffer
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    // One value per channel. The element of the buffer
+    template <class data_t, unsigned int channels> struct Frame
+    {
+            data_t value[channels];
+    };
+
+    template <class data_t, unsigned int channels, class uint_t = unsigned short int, unsigned int N = 0, bool full_capacity = false>
+    class MultiBuffer: private Buffer<Frame<data_t, channels>, uint_t, N, full_capacity>
+    {
+            using Frames = Buffer<buffer::Frame<data_t, channels>, uint_t, N, full_capacity>;
+
+            static_assert (channels > 0, "Template parameter \"channels\" expected to be greater than 0");
+
+        public:
+            using Frame = buffer::Frame<data_t, channels>;
+            // Segments and iterators hold whole frames
+            using Segment = typename Frames::Segment;
+            using Segments = typename Frames::Segments;
+            using iterator = typename Frames::iterator;
+            using const_iterator = typename Frames::const_iterator;
+            using reverse_iterator = typename Frames::reverse_iterator;
+            using const_reverse_iterator = typename Frames::const_reverse_iterator;
+
+        public:
+            /**
+             * @brief MultiBuffer Construct a multi channel circular buffer object. If N is 0,
+             *        the buffer is invalid until init() is called with the memory
+             */
+            MultiBuffer();
+            /**
+             * @brief MultiBuffer Construct a multi channel circular buffer object
+             * @param buffer Pointer to the allocated memory for the buffer
+             * @param size The number of frames in the buffer
+             */
+            MultiBuffer(Frame* buffer, uint_t size);
+
+            inline MultiBuffer& init(Frame* buffer = nullptr, uint_t size = 0);
+            /**
+             * @brief pushFront Push a frame
+             * @param frame Pointer to one value per channel
+             */
+            inline MultiBuffer& pushFront(const data_t* frame);
+            inline MultiBuffer& pushFront(const Frame& frame);
+            /**
+             * @brief pushFront Push a block of frames, the first one first. If the block
+             *                  is bigger than the buffer, only its newest frames are kept
+             * @param frames Pointer to the frames
+             * @param count Number of frames
+             */
+            inline MultiBuffer& pushFront(const Frame* frames, uint_t count);
+            /**
+             * @brief popBack Pop the oldest frame
+             * @param frame Pointer to the memory for one value per channel. If nullptr, the frame is discarded
+             */
+            inline MultiBuffer& popBack(data_t* frame = nullptr);
+            /**
+             * @brief popBack Pop a block of the oldest frames, the oldest one first.
+             *                If the buffer holds less frames, all of them are poped
+             * @param frames Pointer to the memory for the frames. If nullptr, the frames are discarded
+             * @param count Number of frames
+             */
+            inline MultiBuffer& popBack(Frame* frames, uint_t count);
+            inline MultiBuffer& clear();
+            // Frames counted from the newest one as in Buffer::at(). Return nullptr if the frame is not in the buffer
+            inline data_t* first();
+            inline data_t* last();
+            inline data_t* at(uint_t index);
+            inline data_t at(uint_t index, unsigned int channel);
+            // Frame without bounds checking
+            inline data_t* operator[](uint_t index);
+
+            using Frames::full;
+            using Frames::empty;
+            using Frames::valid;
+            using Frames::size;
+            using Frames::count;
+            using Frames::segments;
+            using Frames::begin;
+            using Frames::end;
+            using Frames::cbegin;
+            using Frames::cend;
+            using Frames::rbegin;
+            using Frames::rend;
+            using Frames::crbegin;
+            using Frames::crend;
+    };
+
+    // Multi channel circular buffer with embedded memory of N frames
+    template <class data_t, unsigned int channels, unsigned int N, class uint_t = unsigned short int, bool full_capacity = false>
+    using StaticMultiBuffer = MultiBuffer<data_t, channels, uint_t, N, full_capacity>;
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>::MultiBuffer():
+        Frames()
+    {
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>::MultiBuffer(Frame* buffer, uint_t size):
+        Frames(buffer, size)
+    {
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::init(Frame* buffer, uint_t size)
+    {
+        Frames::init(buffer, size);
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::pushFront(const data_t* frame)
+    {
+        Frame copy;
+        for(unsigned int channel = 0; channel < channels; ++channel) copy.value[channel] = frame[channel];
+
+        Frames::pushFront(copy);
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::pushFront(const Frame& frame)
+    {
+        Frames::pushFront(frame);
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::pushFront(const Frame* frames, uint_t count)
+    {
+        Frames::pushFront(frames, count);
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::popBack(data_t* frame)
+    {
+        const data_t* oldest = last();
+        if(frame && oldest)
+            for(unsigned int channel = 0; channel < channels; ++channel) frame[channel] = oldest[channel];
+
+        Frames::popBack();
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::popBack(Frame* frames, uint_t count)
+    {
+        Frames::popBack(frames, count);
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    MultiBuffer<data_t, channels, uint_t, N, full_capacity>& MultiBuffer<data_t, channels, uint_t, N, full_capacity>::clear()
+    {
+        Frames::clear();
+        return *this;
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    data_t* MultiBuffer<data_t, channels, uint_t, N, full_capacity>::first()
+    {
+        return at(0);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    data_t* MultiBuffer<data_t, channels, uint_t, N, full_capacity>::last()
+    {
+        if(Frames::count() == 0)
+            return nullptr;
+        return at(Frames::count() - 1);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    data_t* MultiBuffer<data_t, channels, uint_t, N, full_capacity>::at(uint_t index)
+    {
+        if(!Frames::valid() || index >= Frames::count())
+            return nullptr;
+        return operator[](index);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    data_t MultiBuffer<data_t, channels, uint_t, N, full_capacity>::at(uint_t index, unsigned int channel)
+    {
+        if(!Frames::valid() || index >= Frames::count() || channel >= channels)
+            return data_t();
+        return operator[](index)[channel];
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity>
+    data_t* MultiBuffer<data_t, channels, uint_t, N, full_capacity>::operator[](uint_t index)
+    {
+        return Frames::operator[](index).value;
+    }
+}
+
+#endif // MULTIBUFFER_H
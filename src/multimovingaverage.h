@@ -0,0 +1,234 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Moving average of several channels that are sampled together. Same result as
+ * one MovingAverage per channel, but all channels share one MultiBuffer.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Keep a running sum per channel
+ * 2. On every in() subtract the poped frame from the sums, when the buffer is full,
+ *    and add the new frame, in the same order as MovingAverage. The loops run over
+ *    the channels of a frame, which are contiguous in memory, so they are vectorizable
+ * 3. The average of a channel is its sum divided by the number of frames. In full
+ *    capacity mode the average of a full window of integers is a shift
+ *
+ * PROS
+ * ----
+ * 1. in() updates the buffer indexes once for all channels
+ * 2. in() and out() are O(1) per channel, independent of the size of the buffer
+ *
+ * CONS
+ * ----
+ *
+ * TYPE
+ * ----
+ * FIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t   - Type of the data, the filter will work with
+ * channels - Number of channels
+ * uint_t   - Type of unsigned integers used troughout the class.
+ *            This type should be chosen carefully based on the CPU/MCU for
+ *            optimal performance. A default type of 16-bit unsigned int is
+ *            sufficient for most cases.
+ * N        - Number of frames in the embedded buffer. If 0, the memory is passed to the constructor
+ * full_capacity - If set, the buffer holds all frames of its memory
+ * sum_t    - Type of the running sums. Same as for MovingAverage, choose a wider type
+ *            for integer data_t, so the sum of the window can not overflow
+ */
+
+#ifndef MULTIMOVINGAVERAGE_H
+#define MULTIMOVINGAVERAGE_H
+
+#include <type_traits>
+#include "multibuffer.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, unsigned int channels, class uint_t = unsigned short int, unsigned int N = 0, bool full_capacity = false, class sum_t = data_t>
+    class MultiMovingAverage: protected buffer::MultiBuffer<data_t, channels, uint_t, N, full_capacity>
+    {
+            using Buffer = buffer::MultiBuffer<data_t, channels, uint_t, N, full_capacity>;
+
+        public:
+            using Frame = typename Buffer::Frame;
+
+        public:
+            MultiMovingAverage();
+            /**
+             * @brief MultiMovingAverage Construct a multi channel moving average filter
+             * @param buffer Pointer to the allocated memory for the circular buffer
+             * @param buffer_size The number of frames in the circular buffer
+             */
+            MultiMovingAverage(Frame *buffer, uint_t buffer_size);
+            // Write the average of every channel to frame
+            void out(data_t *frame);
+            data_t out(unsigned int channel);
+            void in(const data_t *frame);
+            void reset(Frame *buffer, uint_t buffer_size);
+            void reset();
+
+            using Buffer::valid;
+
+        private:
+            inline void updateShift();
+            inline data_t average(const sum_t& sum, uint_t count);
+
+        private:
+            sum_t m_sum[channels];
+            unsigned char m_shift;
+    };
+
+    // MultiMovingAverage with embedded buffer of N frames
+    template <class data_t, unsigned int channels, unsigned int N, class uint_t = unsigned short int, bool full_capacity = false, class sum_t = data_t>
+    using StaticMultiMovingAverage = MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>;
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::MultiMovingAverage():
+        Buffer(),
+        m_sum(),
+        m_shift(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
+        static_assert (N != 0, "Template parameter \"N\" expected to be the size of the embedded buffer");
+
+        updateShift();
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::MultiMovingAverage(Frame *buffer, uint_t buffer_size):
+        Buffer(buffer, buffer_size),
+        m_sum(),
+        m_shift(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_integral_v<data_t> == std::is_integral_v<sum_t> && sizeof(sum_t) >= sizeof(data_t), "Template type \"sum_t\" expected to be at least as wide as \"data_t\"");
+
+        updateShift();
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::out(data_t *frame)
+    {
+        const uint_t buffer_count = Buffer::count();
+
+        if(buffer_count == 0)
+        {
+            for(unsigned int channel = 0; channel < channels; ++channel) frame[channel] = data_t();
+            return;
+        }
+
+        for(unsigned int channel = 0; channel < channels; ++channel) frame[channel] = average(m_sum[channel], buffer_count);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    data_t MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::out(unsigned int channel)
+    {
+        const uint_t buffer_count = Buffer::count();
+
+        if(buffer_count == 0 || channel >= channels)
+            return data_t();
+
+        return average(m_sum[channel], buffer_count);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::in(const data_t *frame)
+    {
+        if(!Buffer::valid()) return;
+
+        // The oldest frame is overwritten by the push, so it is subtracted first
+        if(Buffer::full())
+        {
+            const data_t *last = Buffer::last();
+            for(unsigned int channel = 0; channel < channels; ++channel) m_sum[channel] -= last[channel];
+        }
+
+        for(unsigned int channel = 0; channel < channels; ++channel) m_sum[channel] += frame[channel];
+
+        Buffer::pushFront(frame);
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::reset(Frame *buffer, uint_t buffer_size)
+    {
+        for(unsigned int channel = 0; channel < channels; ++channel) m_sum[channel] = sum_t();
+        Buffer::init(buffer, buffer_size);
+        updateShift();
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::reset()
+    {
+        for(unsigned int channel = 0; channel < channels; ++channel) m_sum[channel] = sum_t();
+        Buffer::clear();
+    }
+
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    void MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::updateShift()
+    {
+        m_shift = 0;
+        while((1UL << m_shift) < Buffer::size()) ++m_shift;
+    }
+
+    // Same result as MovingAverage::out() for one channel
+    template<class data_t, unsigned int channels, class uint_t, unsigned int N, bool full_capacity, class sum_t>
+    data_t MultiMovingAverage<data_t, channels, uint_t, N, full_capacity, sum_t>::average(const sum_t& sum, uint_t count)
+    {
+        if constexpr(std::is_integral_v<sum_t>)
+        {
+            // The full window holds a power of two frames. Negative sums are rounded toward zero as by the division
+            if constexpr(full_capacity)
+            {
+                if(Buffer::full())
+                {
+                    if constexpr(std::is_signed_v<sum_t>)
+                        return data_t((sum + ((sum >> (sizeof(sum_t) * 8 - 1)) & ((sum_t(1) << m_shift) - 1))) >> m_shift);
+                    else
+                        return data_t(sum >> m_shift);
+                }
+            }
+
+            // The count is not converted to sum_t, where it could wrap, and a signed sum is not converted to unsigned
+            if constexpr(std::is_signed_v<sum_t> && sizeof(uint_t) >= sizeof(int))
+                return data_t(sum / static_cast<long long>(count));
+            else
+                return data_t(sum / count);
+        }
+        else return data_t(sum / sum_t(count));
+    }
+}
+
+#endif // MULTIMOVINGAVERAGE_H
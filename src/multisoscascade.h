@@ -0,0 +1,242 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Cascade of second order sections for several channels that are sampled together,
+ * e.g. the axes of a sensor or the channels of an audio frame. Same result as one
+ * SosCascade per channel with the same coefficients. The coefficients are shared by
+ * all channels, only the state is kept per channel.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. The state of every section is stored as s1 of all channels followed by s2 of
+ *    all channels, so the same operation on consecutive channels is done on
+ *    consecutive memory
+ * 2. Every section filters all channels of a frame in a loop without branches or
+ *    dependencies between the channels, so the compiler vectorizes it. Enable the
+ *    target instruction set, e.g. -mavx2, to filter 8 float channels at once
+ * 3. process() filters the whole block with the first section, then with the
+ *    second and so on. The frames are interleaved, as in MultiBuffer
+ *
+ * PROS
+ * ----
+ * 1. The multiplications of all channels run in parallel
+ * 2. One set of coefficients for all channels
+ *
+ * CONS
+ * ----
+ * 1. Floating point only
+ * 2. All channels are filtered with the same coefficients
+ *
+ * TYPE
+ * ----
+ * IIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t   - Type of the data, the filter will work with
+ * channels - Number of channels
+ * uint_t   - Type of unsigned integers used troughout the class.
+ *            This type should be chosen carefully based on the CPU/MCU for
+ *            optimal performance. A default type of 16-bit unsigned int is
+ *            sufficient for most cases.
+ * coeff_t  - Type of the coefficients. float or double
+ */
+
+#ifndef MULTISOSCASCADE_H
+#define MULTISOSCASCADE_H
+
+#include <type_traits>
+#include <cstddef>
+#include "biquad.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, unsigned int channels, class uint_t = unsigned short int, class coeff_t = float>
+    class MultiSosCascade
+    {
+        public:
+            /**
+             * @brief MultiSosCascade Construct a multi channel cascade of second order sections
+             * @param sections Pointer to the coefficients of the sections
+             * @param state Pointer to the allocated memory for the state. Must hold
+             *              2 * count * channels elements
+             * @param count The number of sections
+             */
+            MultiSosCascade(const BiquadCoefficients<coeff_t> *sections, data_t *state, uint_t count);
+            // Write the filtered value of every channel to frame
+            void out(data_t *frame);
+            data_t out(unsigned int channel);
+            void in(const data_t *frame);
+            /**
+             * @brief process Filter a block of frames. Same result as calling in() and out()
+             *                for every frame
+             * @param src Pointer to the frames, channels values each
+             * @param dst Pointer to the memory for the filtered frames. May be the same as src
+             * @param frames Number of frames
+             */
+            void process(const data_t *src, data_t *dst, uint_t frames);
+            void reset(const BiquadCoefficients<coeff_t> *sections, data_t *state, uint_t count);
+            void reset();
+            bool valid();
+
+        private:
+            const BiquadCoefficients<coeff_t> *m_sections;
+            data_t *m_state;
+            uint_t m_count;
+            data_t m_out[channels];
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    MultiSosCascade<data_t, channels, uint_t, coeff_t>::MultiSosCascade(const BiquadCoefficients<coeff_t> *sections, data_t *state, uint_t count):
+        m_sections(sections),
+        m_state(state),
+        m_count((sections && state) ? count : 0),
+        m_out()
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::is_floating_point_v<data_t>, "Template type \"data_t\" expected to be floating point");
+
+        reset();
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    void MultiSosCascade<data_t, channels, uint_t, coeff_t>::out(data_t *frame)
+    {
+        for(unsigned int channel = 0; channel < channels; ++channel) frame[channel] = m_out[channel];
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    data_t MultiSosCascade<data_t, channels, uint_t, coeff_t>::out(unsigned int channel)
+    {
+        if(channel >= channels)
+            return data_t();
+
+        return m_out[channel];
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    void MultiSosCascade<data_t, channels, uint_t, coeff_t>::in(const data_t *frame)
+    {
+        if(m_count == 0) return;
+
+        data_t value[channels];
+        for(unsigned int channel = 0; channel < channels; ++channel) value[channel] = frame[channel];
+
+        for(uint_t section = 0; section < m_count; ++section)
+        {
+            const BiquadCoefficients<coeff_t> &c = m_sections[section];
+            data_t *s1 = m_state + 2 * section * channels;
+            data_t *s2 = s1 + channels;
+
+            // Same expressions as in Biquad::in()
+            for(unsigned int channel = 0; channel < channels; ++channel)
+            {
+                const data_t out = c.b0 * value[channel] + s1[channel];
+                s1[channel] = c.b1 * value[channel] - c.a1 * out + s2[channel];
+                s2[channel] = c.b2 * value[channel] - c.a2 * out;
+                value[channel] = out;
+            }
+        }
+
+        for(unsigned int channel = 0; channel < channels; ++channel) m_out[channel] = value[channel];
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    void MultiSosCascade<data_t, channels, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t frames)
+    {
+        if(m_count == 0 || frames == 0) return;
+
+        for(uint_t section = 0; section < m_count; ++section)
+        {
+            // The first section reads src, the others filter dst in place
+            const data_t *input = section == 0 ? src : dst;
+
+            // Keep the coefficients and the state in local variables for the whole block
+            const coeff_t b0 = m_sections[section].b0, b1 = m_sections[section].b1, b2 = m_sections[section].b2;
+            const coeff_t a1 = m_sections[section].a1, a2 = m_sections[section].a2;
+            data_t s1[channels], s2[channels];
+            for(unsigned int channel = 0; channel < channels; ++channel)
+            {
+                s1[channel] = m_state[2 * section * channels + channel];
+                s2[channel] = m_state[(2 * section + 1) * channels + channel];
+            }
+
+            for(uint_t frame = 0; frame < frames; ++frame)
+            {
+                const data_t *value = input + frame * channels;
+                data_t *filtered = dst + frame * channels;
+
+                for(unsigned int channel = 0; channel < channels; ++channel)
+                {
+                    const data_t x = value[channel];
+                    const data_t out = b0 * x + s1[channel];
+                    s1[channel] = b1 * x - a1 * out + s2[channel];
+                    s2[channel] = b2 * x - a2 * out;
+                    filtered[channel] = out;
+                }
+            }
+
+            for(unsigned int channel = 0; channel < channels; ++channel)
+            {
+                m_state[2 * section * channels + channel] = s1[channel];
+                m_state[(2 * section + 1) * channels + channel] = s2[channel];
+            }
+        }
+
+        const data_t *last = dst + (frames - 1) * channels;
+        for(unsigned int channel = 0; channel < channels; ++channel) m_out[channel] = last[channel];
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    void MultiSosCascade<data_t, channels, uint_t, coeff_t>::reset(const BiquadCoefficients<coeff_t> *sections, data_t *state, uint_t count)
+    {
+        m_sections = sections;
+        m_state = state;
+        m_count = (sections && state) ? count : 0;
+        reset();
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    void MultiSosCascade<data_t, channels, uint_t, coeff_t>::reset()
+    {
+        for(std::size_t i = 0; i < std::size_t(2) * m_count * channels; ++i) m_state[i] = data_t();
+        for(unsigned int channel = 0; channel < channels; ++channel) m_out[channel] = data_t();
+    }
+
+    template <class data_t, unsigned int channels, class uint_t, class coeff_t>
+    bool MultiSosCascade<data_t, channels, uint_t, coeff_t>::valid()
+    {
+        return m_count != 0;
+    }
+}
+
+#endif // MULTISOSCASCADE_H
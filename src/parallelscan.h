@@ -0,0 +1,245 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Filtering of long arrays on several threads for the first order IIR filters,
+ * LowPass and ExpMovingAverage. Meant for offline processing of recordings, where
+ * the whole input is available at once. The result is the same as process()
+ * within the floating point rounding, and the filter continues from the last value.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. Both filters calculate y[i] := a * y[i-1] + b * x[i], where a = 1 - α and b = α.
+ *    The composition of such affine steps is associative, so the array can be split
+ *    into chunks that are filtered independently
+ * 2. Every chunk is filtered by its own thread. The first chunk starts from the value
+ *    of the filter, the others start from 0
+ * 3. The value before every chunk is calculated serially from the last value of the
+ *    previous chunk: y[end] = z[end] + a^length * y[begin - 1]
+ * 4. Every chunk, except the first, adds a^(j+1) * y[begin - 1] to its j-th value.
+ *    The loop stops when a^(j+1) is below the machine epsilon, so usually only the
+ *    beginning of the chunk is visited again
+ *
+ * PROS
+ * ----
+ * 1. Scales with the number of cores
+ * 2. Can filter in place
+ *
+ * CONS
+ * ----
+ * 1. Floating point data and coefficient only
+ * 2. Threads are created on every call, so every chunk is at least
+ *    scan_min_chunk_size values. Shorter arrays are filtered by the calling thread
+ * 3. Needs std::thread. The header is not included by filter.h. If a thread can not
+ *    be created, its chunk is filtered by the calling thread
+ *
+ * TYPE
+ * ----
+ * IIR
+ */
+
+#ifndef PARALLELSCAN_H
+#define PARALLELSCAN_H
+
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <cmath>
+#include <limits>
+#include <thread>
+#include "lowpass.h"
+#include "movingaverageexp.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /******************** CONFIGURATION PARAMETERS *************************/
+    /***********************************************************************/
+
+    // Maximum number of threads used for one array
+    constexpr unsigned int scan_max_threads = 64;
+
+    // Minimum number of values filtered by one thread
+    constexpr std::size_t scan_min_chunk_size = 1 << 16;
+
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    /**
+     * @brief processParallel Filter a long block of values on several threads. Same result as
+     *                        process() within the floating point rounding
+     * @param filter The filter. Continues from its value and keeps the last filtered value
+     * @param src Pointer to the values
+     * @param dst Pointer to the memory for the filtered values. May be the same as src
+     * @param count Number of values
+     * @param threads Maximum number of threads, including the calling thread.
+     *                If 0, the number of hardware threads is used
+     */
+    template <class data_t, class uint_t, class coeff_t>
+    void processParallel(LowPass<data_t, uint_t, coeff_t> &filter, const data_t *src, data_t *dst, std::size_t count, unsigned int threads);
+
+    template <class data_t, class uint_t, class coeff_t>
+    void processParallel(ExpMovingAverage<data_t, uint_t, coeff_t> &filter, const data_t *src, data_t *dst, std::size_t count, unsigned int threads);
+
+    /**
+     * @brief scanParallel Filter with y[i] := step(y[i-1], x[i]), where step is affine in y[i-1]
+     * @param decay The coefficient a of y[i-1]
+     * @param value The value before the first one. Set to the last filtered value
+     * @param step Calculates one filtered value
+     */
+    template <class data_t, class step_t>
+    void scanParallel(const data_t *src, data_t *dst, std::size_t count, data_t decay, data_t &value, const step_t &step, unsigned int threads);
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t, class coeff_t>
+    void processParallel(LowPass<data_t, uint_t, coeff_t> &filter, const data_t *src, data_t *dst, std::size_t count, unsigned int threads)
+    {
+        static_assert (std::is_floating_point_v<data_t> && std::is_floating_point_v<coeff_t>, "Template types \"data_t\" and \"coeff_t\" expected to be floating point");
+
+        std::size_t i = 0;
+
+        // The first values are passed through
+        for(; i < count && filter.m_first_value_offset != 0; ++i)
+        {
+            --filter.m_first_value_offset;
+            filter.m_lowpass = src[i];
+            dst[i] = filter.m_lowpass;
+        }
+
+        const coeff_t alpha = filter.m_alpha;
+        scanParallel(src + i, dst + i, count - i, data_t(1) - data_t(alpha), filter.m_lowpass,
+                     [alpha](const data_t &lowpass, const data_t &value) { return LowPass<data_t, uint_t, coeff_t>::step(lowpass, value, alpha); },
+                     threads);
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void processParallel(ExpMovingAverage<data_t, uint_t, coeff_t> &filter, const data_t *src, data_t *dst, std::size_t count, unsigned int threads)
+    {
+        static_assert (std::is_floating_point_v<data_t> && std::is_floating_point_v<coeff_t>, "Template types \"data_t\" and \"coeff_t\" expected to be floating point");
+
+        std::size_t i = 0;
+
+        // The first values are passed through
+        for(; i < count && filter.m_first_value_offset != 0; ++i)
+        {
+            --filter.m_first_value_offset;
+            filter.m_ema = src[i];
+            dst[i] = filter.m_ema;
+        }
+
+        const coeff_t alpha = filter.m_alpha;
+        scanParallel(src + i, dst + i, count - i, data_t(1) - data_t(alpha), filter.m_ema,
+                     [alpha](const data_t &ema, const data_t &value) { return ExpMovingAverage<data_t, uint_t, coeff_t>::step(ema, value, alpha); },
+                     threads);
+    }
+
+    template <class data_t, class step_t>
+    void scanParallel(const data_t *src, data_t *dst, std::size_t count, data_t decay, data_t &value, const step_t &step, unsigned int threads)
+    {
+        if(threads == 0) threads = std::thread::hardware_concurrency();
+
+        const std::size_t chunks = std::max<std::size_t>(1, std::min<std::size_t>({threads, scan_max_threads, count / scan_min_chunk_size}));
+        const std::size_t chunk_size = (count + chunks - 1) / chunks;
+
+        auto begin = [&](std::size_t chunk) { return std::min(chunk * chunk_size, count); };
+        auto end = [&](std::size_t chunk) { return std::min(chunk * chunk_size + chunk_size, count); };
+
+        // The last value of every chunk, without the values before the chunk
+        data_t last[scan_max_threads];
+
+        auto filterChunk = [&](std::size_t chunk)
+        {
+            data_t filtered = chunk == 0 ? value : data_t();
+            for(std::size_t i = begin(chunk); i < end(chunk); ++i)
+            {
+                filtered = step(filtered, src[i]);
+                dst[i] = filtered;
+            }
+            last[chunk] = filtered;
+        };
+
+        // The value before every chunk
+        data_t carry[scan_max_threads];
+
+        auto correctChunk = [&](std::size_t chunk)
+        {
+            data_t weight = decay;
+            // Below epsilon the correction is smaller than the rounding error of the carry
+            for(std::size_t i = begin(chunk); i < end(chunk) && std::abs(weight) >= std::numeric_limits<data_t>::epsilon(); ++i)
+            {
+                dst[i] += weight * carry[chunk];
+                weight *= decay;
+            }
+        };
+
+        std::thread workers[scan_max_threads];
+
+        // If a thread can not be created, its chunk is done by the calling thread. The started
+        // workers are always joined, so no exception leaves with a joinable std::thread
+        auto start = [&](std::size_t chunk, const auto &task)
+        {
+#if defined(__cpp_exceptions)
+            try
+            {
+                workers[chunk] = std::thread(task, chunk);
+            }
+            catch(...)
+            {
+                task(chunk);
+            }
+#else
+            workers[chunk] = std::thread(task, chunk);
+#endif
+        };
+
+        auto join = [&](std::size_t first)
+        {
+            for(std::size_t chunk = first; chunk < chunks; ++chunk)
+                if(workers[chunk].joinable()) workers[chunk].join();
+        };
+
+        for(std::size_t chunk = 1; chunk < chunks; ++chunk) start(chunk, filterChunk);
+        filterChunk(0);
+        join(1);
+
+        value = last[0];
+        for(std::size_t chunk = 1; chunk < chunks; ++chunk)
+        {
+            carry[chunk] = value;
+            value = last[chunk] + std::pow(decay, data_t(end(chunk) - begin(chunk))) * value;
+        }
+
+        for(std::size_t chunk = 2; chunk < chunks; ++chunk) start(chunk, correctChunk);
+        if(chunks > 1) correctChunk(1);
+        join(2);
+
+        // Same as the last filtered value
+        if(count != 0) value = dst[count - 1];
+    }
+}
+
+#endif // PARALLELSCAN_H
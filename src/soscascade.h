@@ -0,0 +1,226 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Cascade of second order sections (SOS). The output of every Biquad is the input
+ * of the next one, which gives filters of order 2 * sections. Higher order filters
+ * are implemented as cascades of biquads, because a single high order section is
+ * numerically unstable. The sections are allocated by the caller, the same way as
+ * the memory of the buffers.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. in() passes the value through all sections
+ * 2. process() filters the block value by value with groups of up to 4 sections.
+ *    The coefficients and the state of the group are kept in local variables for
+ *    the whole block. The sections of the group work on consecutive values at the
+ *    same time, so the latency of one section is hidden by the others
+ *
+ * PROS
+ * ----
+ * 1. Sharp roll-off. 4 sections give 8th order filter with 48 dB per octave,
+ *    against 6 dB per octave for LowPass
+ * 2. Any combination of sections, e.g. low pass followed by notch
+ *
+ * CONS
+ * ----
+ * 1. Floating point only
+ *
+ * TYPE
+ * ----
+ * IIR
+ *
+ * DATA TYPES
+ * ----------
+ * data_t  - Type of the data, the filter will work with
+ * uint_t  - Type of unsigned integers used troughout the class.
+ *           This type should be chosen carefully based on the CPU/MCU for
+ *           optimal performance. A default type of 16-bit unsigned int is
+ *           sufficient for most cases.
+ * coeff_t - Type of the coefficients. float or double
+ */
+
+#ifndef SOSCASCADE_H
+#define SOSCASCADE_H
+
+#include <type_traits>
+#include "biquad.h"
+
+namespace filter
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int, class coeff_t = float>
+    class SosCascade
+    {
+            using Section = Biquad<data_t, uint_t, coeff_t>;
+
+        public:
+            /**
+             * @brief SosCascade Construct a cascade of second order sections
+             * @param sections Pointer to the sections. The value passes through them in order
+             * @param count The number of sections
+             */
+            SosCascade(Section *sections, uint_t count);
+            data_t out();
+            void in(const data_t& value);
+            /**
+             * @brief process Filter a block of values. Same result as calling in() and out()
+             *                for every value
+             * @param src Pointer to the values
+             * @param dst Pointer to the memory for the filtered values. May be the same as src
+             * @param count Number of values
+             */
+            void process(const data_t *src, data_t *dst, uint_t count);
+            void reset(Section *sections, uint_t count);
+            void reset();
+            bool valid();
+
+        private:
+            template <unsigned int group> void processGroup(Section *sections, const data_t *src, data_t *dst, uint_t count);
+
+        private:
+            // Number of sections that filter a block together
+            static constexpr uint_t group_size = 4;
+
+            Section *m_sections;
+            uint_t m_count;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t, class coeff_t>
+    SosCascade<data_t, uint_t, coeff_t>::SosCascade(Section *sections, uint_t count):
+        m_sections(sections),
+        m_count(sections ? count : 0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    data_t SosCascade<data_t, uint_t, coeff_t>::out()
+    {
+        if(m_count == 0)
+            return data_t();
+
+        return m_sections[m_count - 1].out();
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void SosCascade<data_t, uint_t, coeff_t>::in(const data_t& value)
+    {
+        data_t filtered = value;
+        for(uint_t section = 0; section < m_count; ++section)
+        {
+            m_sections[section].in(filtered);
+            filtered = m_sections[section].out();
+        }
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void SosCascade<data_t, uint_t, coeff_t>::process(const data_t *src, data_t *dst, uint_t count)
+    {
+        if(m_count == 0)
+            return;
+
+        // The first group reads src, the others filter dst in place
+        uint_t section = 0;
+        for(; m_count - section >= group_size; section += group_size)
+        {
+            processGroup<group_size>(m_sections + section, section == 0 ? src : dst, dst, count);
+        }
+
+        const data_t *input = section == 0 ? src : dst;
+        switch(m_count - section)
+        {
+            case 3: processGroup<3>(m_sections + section, input, dst, count); break;
+            case 2: processGroup<2>(m_sections + section, input, dst, count); break;
+            case 1: processGroup<1>(m_sections + section, input, dst, count); break;
+        }
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void SosCascade<data_t, uint_t, coeff_t>::reset(Section *sections, uint_t count)
+    {
+        m_sections = sections;
+        m_count = sections ? count : 0;
+        reset();
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    void SosCascade<data_t, uint_t, coeff_t>::reset()
+    {
+        for(uint_t section = 0; section < m_count; ++section) m_sections[section].reset();
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    bool SosCascade<data_t, uint_t, coeff_t>::valid()
+    {
+        return m_count != 0;
+    }
+
+    template <class data_t, class uint_t, class coeff_t>
+    template <unsigned int group>
+    void SosCascade<data_t, uint_t, coeff_t>::processGroup(Section *sections, const data_t *src, data_t *dst, uint_t count)
+    {
+        // Keep the coefficients and the state in local variables, so they are not reloaded after every store to dst
+        BiquadCoefficients<coeff_t> c[group];
+        data_t out[group], s1[group], s2[group];
+        for(unsigned int i = 0; i < group; ++i)
+        {
+            c[i] = sections[i].m_coefficients;
+            out[i] = sections[i].m_out;
+            s1[i] = sections[i].m_s1;
+            s2[i] = sections[i].m_s2;
+        }
+
+        for(uint_t i = 0; i < count; ++i)
+        {
+            data_t value = src[i];
+
+            // Same expressions as in Biquad::in()
+            for(unsigned int j = 0; j < group; ++j)
+            {
+                out[j] = c[j].b0 * value + s1[j];
+                s1[j] = c[j].b1 * value - c[j].a1 * out[j] + s2[j];
+                s2[j] = c[j].b2 * value - c[j].a2 * out[j];
+                value = out[j];
+            }
+
+            dst[i] = value;
+        }
+
+        for(unsigned int i = 0; i < group; ++i)
+        {
+            sections[i].m_out = out[i];
+            sections[i].m_s1 = s1[i];
+            sections[i].m_s2 = s2[i];
+        }
+    }
+}
+
+#endif // SOSCASCADE_H
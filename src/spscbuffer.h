@@ -0,0 +1,420 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Lock-free circular buffer for one producer thread and one consumer thread. The
+ * producer pushes values to the front, the consumer pops them from the back, for
+ * example to feed them into a filter. Unlike Buffer, a full buffer does not overwrite
+ * the oldest values, the push fails instead.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. The head is written only by the producer, the tail only by the consumer. Both
+ *    are free running and masked only when the memory is accessed, so all elements
+ *    of the memory are used and the number of values is head - tail
+ * 2. The producer writes the values and then publishes the new head with release
+ *    ordering. The consumer reads the head with acquire ordering, so it sees the
+ *    values. The tail is published the same way in the opposite direction
+ * 3. Each side keeps a cached copy of the index of the other side and reloads it
+ *    only when the buffer looks full or empty
+ * 4. The indexes of the two sides are in separate cache lines, so they do not bounce
+ *    between the cores. Block operations publish the index once per block
+ *
+ * PROS
+ * ----
+ * 1. No locks. Push and pop are wait-free
+ * 2. The memory is managed by the user, the same way as for Buffer
+ *
+ * CONS
+ * ----
+ * 1. Only one producer thread and one consumer thread
+ * 2. The size of the buffer must be a power of 2
+ * 3. The object is aligned to the cache line size
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data the buffer will work with
+ * uint_t - Type of unsigned integers used troughout the class. Must be lock-free
+ *          as std::atomic. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ */
+
+#ifndef SPSCBUFFER_H
+#define SPSCBUFFER_H
+
+#include <type_traits>
+#include <stdexcept>
+#include <atomic>
+#include <cstring>
+#include "buffer.h"
+
+namespace buffer
+{
+    /***********************************************************************/
+    /******************** CONFIGURATION PARAMETERS *************************/
+    /***********************************************************************/
+
+    /* Size of the CPU cache line. The producer and the consumer indexes are
+     * placed this many bytes apart, so they do not share a cache line.
+     */
+    constexpr unsigned int cache_line_size = 64;
+
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int> class SpscBuffer
+    {
+        public:
+            SpscBuffer();
+            /**
+             * @brief SpscBuffer Construct a single producer, single consumer buffer object
+             * @param buffer Pointer to the allocated memory for the buffer
+             * @param size The number of elements in the buffer. All of them are used
+             */
+            SpscBuffer(data_t* buffer, uint_t size);
+
+            // Not thread safe. Neither the producer, nor the consumer may use the buffer meanwhile
+            inline SpscBuffer& init(data_t* buffer = nullptr, uint_t size = 0);
+
+            // Producer side
+            inline bool pushFront(const data_t& value);
+            /**
+             * @brief pushFront Push a block of values, src[0] first. The values are
+             *                  published to the consumer at once
+             * @param src Pointer to the values
+             * @param count Number of values
+             * @return Number of pushed values. Less than count if the buffer is full
+             */
+            inline uint_t pushFront(const data_t* src, uint_t count);
+
+            // Consumer side
+            inline bool popBack(data_t* value = nullptr);
+            /**
+             * @brief popBack Pop a block of the oldest values, the oldest one first.
+             *                The memory is released to the producer at once
+             * @param dst Pointer to the memory for the values. If nullptr, the values are discarded
+             * @param count Number of values
+             * @return Number of poped values
+             */
+            inline uint_t popBack(data_t* dst, uint_t count);
+            /**
+             * @brief drain Feed all available values to a filter, the oldest one first.
+             *              The memory is released to the producer at once
+             * @param filter Any object with an in() method
+             * @return Number of values fed to the filter
+             */
+            template <class filter_t> inline uint_t drain(filter_t& filter);
+            inline SpscBuffer& clear();
+
+            // Both sides. The result may be outdated by the time it is used
+            inline bool full();
+            inline bool empty();
+            inline bool valid();
+            inline uint_t size();
+            inline uint_t count();
+
+        private:
+            static inline void copy(data_t* dst, const data_t* src, uint_t count);
+
+        private:
+            // Written by the producer
+            alignas(cache_line_size) std::atomic<uint_t> m_head;
+            uint_t m_tail_cache;
+
+            // Written by the consumer
+            alignas(cache_line_size) std::atomic<uint_t> m_tail;
+            uint_t m_head_cache;
+
+            // Written only by init()
+            alignas(cache_line_size) data_t* m_buffer;
+            uint_t m_buffer_mask;
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t>
+    SpscBuffer<data_t, uint_t>::SpscBuffer():
+        SpscBuffer(nullptr, 0)
+    {
+    }
+
+    template<class data_t, class uint_t>
+    SpscBuffer<data_t, uint_t>::SpscBuffer(data_t* buffer, uint_t size):
+        m_head(0),
+        m_tail_cache(0),
+        m_tail(0),
+        m_head_cache(0),
+        m_buffer(nullptr),
+        m_buffer_mask(0)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+        static_assert (std::atomic<uint_t>::is_always_lock_free, "Template type \"uint_t\" expected to be lock-free as std::atomic");
+
+        if(buffer == nullptr)
+            return;
+
+        // Same requirements as for Buffer
+        if(size <= 3)
+        {
+            if constexpr(use_exceptions)
+            {
+                throw std::invalid_argument("Size of the buffer must be at least 4");
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        if(size & (size - 1))
+        {
+            if constexpr(use_exceptions)
+            {
+                throw std::invalid_argument("Size of the buffer must a power of two(4, 8, 16, 32, ...)");
+            }
+            else
+            {
+                return;
+            }
+        }
+
+        m_buffer_mask = size - 1;
+        m_buffer = buffer;
+    }
+
+    template<class data_t, class uint_t>
+    SpscBuffer<data_t, uint_t>& SpscBuffer<data_t, uint_t>::init(data_t* buffer, uint_t size)
+    {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_tail_cache = 0;
+        m_head_cache = 0;
+
+        if(buffer == nullptr)
+        {
+            m_buffer_mask = 0;
+            m_buffer = nullptr;
+        }
+        else
+        {
+            m_buffer_mask = size - 1;
+            m_buffer = buffer;
+        }
+
+        // Make the reset indexes visible to threads started after the call
+        std::atomic_thread_fence(std::memory_order_release);
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t>
+    bool SpscBuffer<data_t, uint_t>::pushFront(const data_t& value)
+    {
+        if(m_buffer == nullptr)
+            return false;
+
+        const uint_t head = m_head.load(std::memory_order_relaxed);
+
+        // The buffer looks full, check if the consumer freed some memory meanwhile
+        if(uint_t(head - m_tail_cache) > m_buffer_mask)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            if(uint_t(head - m_tail_cache) > m_buffer_mask)
+                return false;
+        }
+
+        m_buffer[head & m_buffer_mask] = value;
+        m_head.store(uint_t(head + 1), std::memory_order_release);
+
+        return true;
+    }
+
+    template<class data_t, class uint_t>
+    uint_t SpscBuffer<data_t, uint_t>::pushFront(const data_t* src, uint_t count)
+    {
+        if(m_buffer == nullptr || src == nullptr || count == 0)
+            return 0;
+
+        const uint_t head = m_head.load(std::memory_order_relaxed);
+
+        // Push as many values as there is free memory for
+        uint_t free_count = m_buffer_mask + 1 - uint_t(head - m_tail_cache);
+        if(free_count < count)
+        {
+            m_tail_cache = m_tail.load(std::memory_order_acquire);
+            free_count = m_buffer_mask + 1 - uint_t(head - m_tail_cache);
+            if(free_count < count)
+                count = free_count;
+        }
+
+        // Copy in at most two segments: up to the end of the memory and then from its beginning
+        const uint_t index = head & m_buffer_mask;
+        uint_t first_segment = m_buffer_mask + 1 - index;
+        if(first_segment > count)
+            first_segment = count;
+
+        copy(m_buffer + index, src, first_segment);
+        copy(m_buffer, src + first_segment, count - first_segment);
+
+        m_head.store(uint_t(head + count), std::memory_order_release);
+
+        return count;
+    }
+
+    template<class data_t, class uint_t>
+    bool SpscBuffer<data_t, uint_t>::popBack(data_t* value)
+    {
+        if(m_buffer == nullptr)
+            return false;
+
+        const uint_t tail = m_tail.load(std::memory_order_relaxed);
+
+        // The buffer looks empty, check if the producer published some values meanwhile
+        if(m_head_cache == tail)
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            if(m_head_cache == tail)
+                return false;
+        }
+
+        if(value)
+            *value = m_buffer[tail & m_buffer_mask];
+        m_tail.store(uint_t(tail + 1), std::memory_order_release);
+
+        return true;
+    }
+
+    template<class data_t, class uint_t>
+    uint_t SpscBuffer<data_t, uint_t>::popBack(data_t* dst, uint_t count)
+    {
+        if(m_buffer == nullptr)
+            return 0;
+
+        const uint_t tail = m_tail.load(std::memory_order_relaxed);
+
+        uint_t available = uint_t(m_head_cache - tail);
+        if(available < count)
+        {
+            m_head_cache = m_head.load(std::memory_order_acquire);
+            available = uint_t(m_head_cache - tail);
+            if(available < count)
+                count = available;
+        }
+
+        if(dst)
+        {
+            // Copy in at most two segments: up to the end of the memory and then from its beginning
+            const uint_t index = tail & m_buffer_mask;
+            uint_t first_segment = m_buffer_mask + 1 - index;
+            if(first_segment > count)
+                first_segment = count;
+
+            copy(dst, m_buffer + index, first_segment);
+            copy(dst + first_segment, m_buffer, count - first_segment);
+        }
+
+        m_tail.store(uint_t(tail + count), std::memory_order_release);
+
+        return count;
+    }
+
+    template<class data_t, class uint_t>
+    template<class filter_t>
+    uint_t SpscBuffer<data_t, uint_t>::drain(filter_t& filter)
+    {
+        if(m_buffer == nullptr)
+            return 0;
+
+        const uint_t tail = m_tail.load(std::memory_order_relaxed);
+        m_head_cache = m_head.load(std::memory_order_acquire);
+
+        const uint_t count = uint_t(m_head_cache - tail);
+        for(uint_t i = 0; i < count; ++i)
+            filter.in(m_buffer[uint_t(tail + i) & m_buffer_mask]);
+
+        m_tail.store(m_head_cache, std::memory_order_release);
+
+        return count;
+    }
+
+    // Consumer side. Discard all published values
+    template<class data_t, class uint_t>
+    SpscBuffer<data_t, uint_t>& SpscBuffer<data_t, uint_t>::clear()
+    {
+        m_head_cache = m_head.load(std::memory_order_acquire);
+        m_tail.store(m_head_cache, std::memory_order_release);
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t>
+    bool SpscBuffer<data_t, uint_t>::full()
+    {
+        return m_buffer != nullptr && count() > m_buffer_mask;
+    }
+
+    template<class data_t, class uint_t>
+    bool SpscBuffer<data_t, uint_t>::empty()
+    {
+        return count() == 0;
+    }
+
+    template<class data_t, class uint_t>
+    bool SpscBuffer<data_t, uint_t>::valid()
+    {
+        return m_buffer != nullptr;
+    }
+
+    template<class data_t, class uint_t>
+    uint_t SpscBuffer<data_t, uint_t>::size()
+    {
+        return m_buffer == nullptr ? 0 : m_buffer_mask + 1;
+    }
+
+    template<class data_t, class uint_t>
+    uint_t SpscBuffer<data_t, uint_t>::count()
+    {
+        // Load the tail first. The head can only grow meanwhile, so the difference never underflows
+        const uint_t tail = m_tail.load(std::memory_order_acquire);
+        const uint_t head = m_head.load(std::memory_order_acquire);
+        return uint_t(head - tail);
+    }
+
+    template<class data_t, class uint_t>
+    void SpscBuffer<data_t, uint_t>::copy(data_t* dst, const data_t* src, uint_t count)
+    {
+        if constexpr(std::is_trivially_copyable_v<data_t>)
+        {
+            if(count) std::memcpy(dst, src, count * sizeof(data_t));
+        }
+        else
+        {
+            for(uint_t i = 0; i < count; ++i) dst[i] = src[i];
+        }
+    }
+}
+
+#endif // SPSCBUFFER_H
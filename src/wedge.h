@@ -0,0 +1,161 @@
+/*
+ *
+ *  _   _   _        __   _   _   _
+ * | | (_) | |__    / _| (_) | | | |_    ___   _ __           _ __     __ _
+ * | | | | | '_ \  | |_  | | | | | __|  / _ \ | '__|  _____  | '_ \   / _` |
+ * | | | | | |_) | |  _| | | | | | |_  |  __/ | |    |_____| | | | | | (_| |
+ * |_| |_| |_.__/  |_|   |_| |_|  \__|  \___| |_|            |_| |_|  \__, |
+ *                                                                    |___/
+ *
+ * A self contained, header only library providing a set of filters
+ * written in C++17 with efficiency in mind
+ *
+ * Version: 1.0.0
+ * URL: https://github.com/ekondayan/libfilter-ng.git
+ *
+ * Copyright (c) 2019,2020 Emil Kondayan
+ *
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/.
+ *
+ *
+ * DESCRIPTION
+ * -----------
+ * Monotonic wedge for tracking the minimum or the maximum of a sliding window.
+ * It is a circular buffer that holds only the values of the window that can still
+ * become the extreme, ordered from the oldest to the newest. The extreme is always
+ * the oldest value in the wedge.
+ *
+ * ALGORITHM
+ * ---------
+ * 1. When a value enters the window, pop from the front all values that it dominates
+ *    (greater values for a minimum wedge, lesser values for a maximum wedge), then push
+ *    it to the front. Equal values are kept, so that every occurrence can be evicted
+ * 2. When a value leaves the window, pop it from the back if it is the extreme.
+ *    If it is not, it was already dominated and removed
+ * 3. Every value is pushed and popped at most once, so the cost is amortized O(1)
+ *
+ * PROS
+ * ----
+ * 1. Amortized O(1) update, O(1) extreme
+ * 2. No rescanning of the window
+ *
+ * CONS
+ * ----
+ * 1. Require a buffer with the same size as the window buffer
+ *
+ * DATA TYPES
+ * ----------
+ * data_t - Type of the data the wedge will work with
+ * uint_t - Type of unsigned integers used troughout the class.
+ *          This type should be chosen carefully based on the CPU/MCU for
+ *          optimal performance. A default type of 16-bit unsigned int is
+ *          sufficient for most cases.
+ * maximum - Track the maximum if true, the minimum otherwise
+ */
+
+#ifndef WEDGE_H
+#define WEDGE_H
+
+#include <type_traits>
+#include "buffer.h"
+
+namespace buffer
+{
+    /***********************************************************************/
+    /***************************** Declaration *****************************/
+    /***********************************************************************/
+
+    template <class data_t, class uint_t = unsigned short int, bool maximum = false>
+    class Wedge: protected Buffer<data_t, uint_t>
+    {
+            using Buffer = buffer::Buffer<data_t, uint_t>;
+
+        public:
+            Wedge();
+            /**
+             * @brief Wedge Construct a monotonic wedge object
+             * @param buffer Pointer to the allocated memory for the wedge
+             * @param size The number of elements in the buffer. Must be the same
+             *             as the size of the window buffer
+             */
+            Wedge(data_t* buffer, uint_t size);
+
+            inline Wedge& init(data_t* buffer = nullptr, uint_t size = 0);
+            inline Wedge& push(const data_t& value);
+            inline Wedge& pop(const data_t& value);
+            inline data_t extreme();
+
+            using Buffer::clear;
+            using Buffer::empty;
+            using Buffer::valid;
+
+        private:
+            inline bool dominates(const data_t& lhs, const data_t& rhs);
+    };
+
+    /***********************************************************************/
+    /***************************** Definition ******************************/
+    /***********************************************************************/
+
+    template<class data_t, class uint_t, bool maximum>
+    Wedge<data_t, uint_t, maximum>::Wedge():
+        Buffer()
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    Wedge<data_t, uint_t, maximum>::Wedge(data_t* buffer, uint_t size):
+        Buffer(buffer, size)
+    {
+        static_assert (std::is_unsigned_v<uint_t>, "Template type \"uint_t\" expected to be of unsigned numeric type");
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    Wedge<data_t, uint_t, maximum>& Wedge<data_t, uint_t, maximum>::init(data_t* buffer, uint_t size)
+    {
+        Buffer::init(buffer, size);
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    Wedge<data_t, uint_t, maximum>& Wedge<data_t, uint_t, maximum>::push(const data_t& value)
+    {
+        // Values dominated by the new one can never become the extreme again
+        while(!Buffer::empty() && dominates(value, Buffer::first()))
+            Buffer::popFront();
+
+        Buffer::pushFront(value);
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    Wedge<data_t, uint_t, maximum>& Wedge<data_t, uint_t, maximum>::pop(const data_t& value)
+    {
+        // The value leaving the window is in the wedge only if it is the extreme
+        if(!Buffer::empty() && Buffer::last() == value)
+            Buffer::popBack();
+
+        return *this;
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    data_t Wedge<data_t, uint_t, maximum>::extreme()
+    {
+        return Buffer::last();
+    }
+
+    template<class data_t, class uint_t, bool maximum>
+    bool Wedge<data_t, uint_t, maximum>::dominates(const data_t& lhs, const data_t& rhs)
+    {
+        if constexpr(maximum)
+            return rhs < lhs;
+        else
+            return lhs < rhs;
+    }
+}
+
+#endif // WEDGE_H
@@ -0,0 +1,100 @@
+/*
+ * Test for filter::FilterArena
+ *
+ * Creates filters with one buffer, with one additional buffer and with two
+ * additional buffers, among them MovingMostFrequentOccurrence, and compares
+ * their output with the same filters on separately allocated memory. Also checks
+ * that buffer sizes which do not fit in the uint_t of the filter are rejected.
+ *
+ * Build from the root of the repository and run:
+ *     g++ -std=c++17 -Wall -Wextra -Isrc tests/filterarena_test.cpp -o filterarena_test
+ *     ./filterarena_test
+ *
+ * Exits with 0 if all checks pass, 1 otherwise.
+ */
+
+#include <cstdio>
+#include "filter.h"
+
+namespace
+{
+    unsigned long errors = 0;
+
+    void check(bool condition, const char* message)
+    {
+        if(condition) return;
+
+        std::printf("failed: %s\n", message);
+        ++errors;
+    }
+}
+
+int main()
+{
+    using Arena = filter::FilterArena;
+    using Occurrence = filter::MovingMostFrequentOccurrence<int>;
+    using Bin = filter::MovingMostFrequentBin<float>;
+
+    static unsigned char memory[1 << 16];
+    Arena arena(memory, sizeof(memory));
+
+    auto *mov_avg = arena.createWindowed<filter::MovingAverage<float>, float>(16);
+    auto *mov_mid = arena.createWindowed<filter::MovingMiddle<float>, float>(16, Arena::Auxiliary<float>{16});
+    auto *mov_heap = arena.createWindowed<filter::MovingMedianHeap<float>, float>(16, Arena::Auxiliary<unsigned short int>{32});
+    auto *mov_mfo = arena.createWindowed<Occurrence, int>(16, Arena::Auxiliary<Occurrence::Occurrence>{16}, Arena::Auxiliary<unsigned short int>{48});
+    auto *mov_mfb = arena.createWindowed<Bin, float>(16, Arena::Auxiliary<Bin::Bin>{8}, Arena::Auxiliary<unsigned short int>{16}, 0.0f, 1.0f, 8);
+
+    check(mov_avg && mov_avg->valid(), "MovingAverage created");
+    check(mov_mid && mov_mid->valid(), "MovingMiddle created");
+    check(mov_heap && mov_heap->valid(), "MovingMedianHeap created");
+    check(mov_mfo && mov_mfo->valid(), "MovingMostFrequentOccurrence created");
+    check(mov_mfb && mov_mfb->valid(), "MovingMostFrequentBin created");
+    if(errors) return 1;
+
+    // The same filters on their own memory
+    float avg_buffer[16], mid_buffer[16], mid_sorted[16], heap_buffer[16], mfb_buffer[16];
+    unsigned short int heap_index[32], mfb_list[16], mfo_index[48];
+    int mfo_buffer[16];
+    Occurrence::Occurrence mfo_records[16];
+    Bin::Bin mfb_bins[8];
+
+    filter::MovingAverage<float> avg(avg_buffer, 16);
+    filter::MovingMiddle<float> mid(mid_buffer, mid_sorted, 16);
+    filter::MovingMedianHeap<float> heap(heap_buffer, heap_index, 16);
+    Occurrence mfo(mfo_buffer, mfo_records, mfo_index, 16);
+    Bin mfb(mfb_buffer, mfb_bins, mfb_list, 16, 0.0f, 1.0f, 8);
+
+    unsigned int seed = 1;
+    for(int i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245U + 12345U;
+        const int value = int((seed >> 16) % 8);
+
+        mov_avg->in(float(value));
+        mov_mid->in(float(value));
+        mov_heap->in(float(value));
+        mov_mfo->in(value);
+        mov_mfb->in(float(value));
+        avg.in(float(value));
+        mid.in(float(value));
+        heap.in(float(value));
+        mfo.in(value);
+        mfb.in(float(value));
+
+        check(mov_avg->out() == avg.out(), "MovingAverage output");
+        check(mov_mid->out() == mid.out(), "MovingMiddle output");
+        check(mov_heap->out() == heap.out(), "MovingMedianHeap output");
+        check(mov_mfo->out() == mfo.out(), "MovingMostFrequentOccurrence output");
+        check(mov_mfb->out() == mfb.out(), "MovingMostFrequentBin output");
+    }
+
+    // 65536 would be truncated to 0 by the 16-bit uint_t. Nothing is allocated
+    const std::size_t used = arena.used();
+    check(arena.createWindowed<filter::MovingAverage<float>, float>(65536) == nullptr, "MovingAverage size overflow");
+    check(arena.createWindowed<Occurrence, int>(65536, Arena::Auxiliary<Occurrence::Occurrence>{16}, Arena::Auxiliary<unsigned short int>{48}) == nullptr, "MovingMostFrequentOccurrence size overflow");
+    check(arena.used() == used, "No allocation on overflow");
+
+    std::printf("%lu errors\n", errors);
+
+    return errors == 0 ? 0 : 1;
+}
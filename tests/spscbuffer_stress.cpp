@@ -0,0 +1,117 @@
+/*
+ * Concurrent stress test for buffer::SpscBuffer
+ *
+ * One producer thread pushes an increasing sequence of numbers with single and
+ * block pushes. One consumer thread takes them with single pops, block pops and
+ * drain() and checks that every number arrives exactly once and in order. The
+ * free running indexes of the 16-bit default uint_t wrap many times.
+ *
+ * Build from the root of the repository and run under ThreadSanitizer:
+ *     g++ -std=c++17 -O1 -g -fsanitize=thread -pthread -Isrc tests/spscbuffer_stress.cpp -o spscbuffer_stress
+ *     ./spscbuffer_stress [values]
+ *
+ * Exits with 0 if all values arrived in order, 1 otherwise.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "spscbuffer.h"
+
+namespace
+{
+    // Checks the sequence, used as the filter for drain()
+    struct Sequence
+    {
+        unsigned long expected = 0;
+        unsigned long errors = 0;
+
+        void in(const unsigned int& value)
+        {
+            if(value != static_cast<unsigned int>(expected)) ++errors;
+            expected = value + 1UL;
+        }
+    };
+
+    template <class uint_t>
+    unsigned long run(unsigned int *memory, uint_t size, unsigned long values)
+    {
+        buffer::SpscBuffer<unsigned int, uint_t> queue(memory, size);
+        Sequence sequence;
+
+        std::thread producer([&]
+        {
+            unsigned int block[37];
+            unsigned long value = 0;
+            while(value < values)
+            {
+                // Alternate single values and blocks of different length
+                if(value % 3 == 0)
+                {
+                    if(queue.pushFront(static_cast<unsigned int>(value))) ++value;
+                    else std::this_thread::yield();
+                    continue;
+                }
+
+                uint_t count = 0;
+                for(; count < 1 + value % 37 && value + count < values; ++count) block[count] = static_cast<unsigned int>(value + count);
+                const uint_t pushed = queue.pushFront(block, count);
+                if(pushed == 0) std::this_thread::yield();
+                value += pushed;
+            }
+        });
+
+        std::thread consumer([&]
+        {
+            unsigned int block[50];
+            unsigned int mode = 0;
+            while(sequence.expected < values)
+            {
+                // Give the producer a turn on machines with a single core
+                if(queue.empty()) std::this_thread::yield();
+
+                switch(mode++ % 3)
+                {
+                    case 0:
+                    {
+                        unsigned int value;
+                        if(queue.popBack(&value)) sequence.in(value);
+                        break;
+                    }
+                    case 1:
+                    {
+                        const uint_t count = queue.popBack(block, 50);
+                        for(uint_t i = 0; i < count; ++i) sequence.in(block[i]);
+                        break;
+                    }
+                    default:
+                        queue.drain(sequence);
+                }
+            }
+        });
+
+        producer.join();
+        consumer.join();
+
+        if(!queue.empty()) ++sequence.errors;
+
+        return sequence.errors;
+    }
+}
+
+int main(int argc, char **argv)
+{
+    const unsigned long values = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 1000000UL;
+
+    static unsigned int memory[1024];
+    unsigned long errors = 0;
+
+    // Small buffer, the producer often finds it full
+    errors += run<unsigned short int>(memory, 16, values);
+    errors += run<unsigned short int>(memory, 1024, values);
+    errors += run<unsigned int>(memory, 64, values);
+
+    std::printf("%lu values, %lu errors\n", values, errors);
+
+    return errors == 0 ? 0 : 1;
+}